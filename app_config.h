@@ -0,0 +1,276 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef APP_CONFIG_H_
+#define APP_CONFIG_H_
+
+//--------------------------------------------------------------------
+// Application configuration, in the spirit of tusb_config.h. Every value can be
+// overridden from the compiler command line.
+//--------------------------------------------------------------------
+
+//------------- Object pools -------------//
+// All dynamic objects come from fixed-size pools (see pool.h), sized here
+
+// HID reports waiting for their endpoint
+#ifndef CFG_POOL_REPORTS
+#define CFG_POOL_REPORTS        16
+#endif
+
+// CDC command lines being received or waiting to run
+#ifndef CFG_POOL_COMMANDS
+#define CFG_POOL_COMMANDS       4
+#endif
+
+// Motion macros queued with the "move" command
+#ifndef CFG_POOL_MACROS
+#define CFG_POOL_MACROS         8
+#endif
+
+//------------- Console -------------//
+
+// Longest CDC command line, including terminator
+#ifndef CFG_CONSOLE_LINE_MAX
+#define CFG_CONSOLE_LINE_MAX    64
+#endif
+
+//------------- Code placement -------------//
+
+// Run the application's report path (generation, queue, HID callbacks) from SRAM
+// instead of XIP flash. Set by the PICO_MOUSE_RAM_HOT_PATHS CMake option, which also
+// sets PICO_RP2040_USB_FAST_IRQ for the TinyUSB IRQ handler. tud_task() and the
+// TinyUSB code it calls are not covered and still run from flash, so the loop is
+// not free of XIP misses; only the copy_to_ram image (dev_hid_composite_ram) is.
+#ifndef CFG_RAM_HOT_PATHS
+#define CFG_RAM_HOT_PATHS       0
+#endif
+
+// Keep data private to a core in that core's scratch bank, beside its stack (the
+// SDK links the core 0 stack into SCRATCH_Y and the core 1 stack into SCRATCH_X).
+// Data shared by both cores stays in the striped main SRAM.
+#ifndef CFG_CORE_SRAM_PLACEMENT
+#define CFG_CORE_SRAM_PLACEMENT 1
+#endif
+
+// Most bytes of __core0_data() in SCRATCH_Y, checked at compile time in report_queue.c.
+// The 4 KB bank also holds the core 0 stack: the linker only reserves PICO_STACK_SIZE
+// (2 KB by default) for it, the rest is margin for deeper calls.
+#ifndef CFG_CORE0_DATA_MAX
+#define CFG_CORE0_DATA_MAX      1024
+#endif
+
+#if CFG_RAM_HOT_PATHS || CFG_CORE_SRAM_PLACEMENT
+  #include "pico.h"
+#endif
+
+#if CFG_RAM_HOT_PATHS
+  #define __hot_path_func(_name)  __not_in_flash_func(_name)
+#else
+  #define __hot_path_func(_name)  _name
+#endif
+
+#if CFG_CORE_SRAM_PLACEMENT
+  #define __core0_data(_group)    __scratch_y(_group)
+  #define __core1_data(_group)    __scratch_x(_group)
+#else
+  #define __core0_data(_group)
+  #define __core1_data(_group)
+#endif
+
+//------------- Suspend -------------//
+
+// While suspended only the wake button is polled, at this interval
+#ifndef CFG_SUSPEND_POLL_MS
+#define CFG_SUSPEND_POLL_MS     20
+#endif
+
+// Gate all clocks but the timer and USB ones between polls, needed for the 2.5 mA suspend budget
+#ifndef CFG_SUSPEND_DEEP_SLEEP
+#define CFG_SUSPEND_DEEP_SLEEP  1
+#endif
+
+//------------- Bus reset -------------//
+// Default policy for work in progress across a bus reset or disconnect, 1: keep and resume, 0: flush.
+// Can be changed at run time with the "policy" console command.
+
+#ifndef CFG_RESET_KEEP_REPORTS
+#define CFG_RESET_KEEP_REPORTS  1
+#endif
+
+#ifndef CFG_RESET_KEEP_MOTION
+#define CFG_RESET_KEEP_MOTION   1
+#endif
+
+#ifndef CFG_RESET_KEEP_COMMANDS
+#define CFG_RESET_KEEP_COMMANDS 1
+#endif
+
+//------------- Frame clock -------------//
+
+// Frames between two drift measurements of the crystal against the host (sof_clock.h)
+#ifndef CFG_SOF_DRIFT_FRAMES
+#define CFG_SOF_DRIFT_FRAMES    4096
+#endif
+
+//------------- Watchdog -------------//
+
+// Main loop hang time before the watchdog resets the chip, above the longest flash erase
+#ifndef CFG_WATCHDOG_MS
+#define CFG_WATCHDOG_MS         1000
+#endif
+
+// Interval of the warm restart snapshot
+#ifndef CFG_SNAPSHOT_MS
+#define CFG_SNAPSHOT_MS         100
+#endif
+
+// Watchdog resets in a row after which the snapshot is discarded and the device cold boots,
+// so a state that hangs the main loop cannot boot-loop
+#ifndef CFG_RECOVERY_MAX_WARM
+#define CFG_RECOVERY_MAX_WARM   3
+#endif
+
+// Main loop run time after which a restart no longer counts as consecutive
+#ifndef CFG_RECOVERY_CLEAN_MS
+#define CFG_RECOVERY_CLEAN_MS   10000
+#endif
+
+//------------- Clock scaling -------------//
+
+// Idle time before clk_sys drops from pll_sys to 48 MHz, the hysteresis of the scaling
+#ifndef CFG_CLOCK_IDLE_MS
+#define CFG_CLOCK_IDLE_MS       500
+#endif
+
+//------------- Key-value store -------------//
+
+// Flash sectors of the store, used as a ring for wear leveling (at least 2)
+#ifndef CFG_KV_SECTORS
+#define CFG_KV_SECTORS          4
+#endif
+
+// Keys are small integers indexed directly in RAM: 0 .. CFG_KV_MAX_KEYS-1
+#ifndef CFG_KV_MAX_KEYS
+#define CFG_KV_MAX_KEYS         32
+#endif
+
+// Largest value in bytes
+#ifndef CFG_KV_VALUE_MAX
+#define CFG_KV_VALUE_MAX        64
+#endif
+
+// How long a flash operation waits for core 1 to be parked before giving up
+#ifndef CFG_FLASH_LOCKOUT_TIMEOUT_MS
+#define CFG_FLASH_LOCKOUT_TIMEOUT_MS  10
+#endif
+
+//------------- Event log -------------//
+
+// Flash sectors of the log ring, below the key-value store (at least 2)
+#ifndef CFG_LOG_SECTORS
+#define CFG_LOG_SECTORS         4
+#endif
+
+// Longest time a logged event waits in RAM before its page is written
+#ifndef CFG_LOG_FLUSH_MS
+#define CFG_LOG_FLUSH_MS        10000
+#endif
+
+// Main loop gap logged as a stall
+#ifndef CFG_LOG_STALL_MS
+#define CFG_LOG_STALL_MS        100
+#endif
+
+// Interval of the counters record
+#ifndef CFG_LOG_COUNTERS_MS
+#define CFG_LOG_COUNTERS_MS     60000
+#endif
+
+// A "log dump" the terminal stopped reading for this long is abandoned, flushing resumes
+#ifndef CFG_LOG_DUMP_TIMEOUT_MS
+#define CFG_LOG_DUMP_TIMEOUT_MS 2000
+#endif
+
+//------------- Firmware update -------------//
+
+// Boot stage and firmware slot sizes (sector multiples). The build links each image for its
+// slot and passes these, keep the defaults in step with CMakeLists.txt
+#ifndef CFG_BOOT_STAGE_SIZE
+#define CFG_BOOT_STAGE_SIZE     (32 * 1024)
+#endif
+
+#ifndef CFG_FIRMWARE_SLOT_SIZE
+#define CFG_FIRMWARE_SLOT_SIZE  (512 * 1024)
+#endif
+
+// Slot this image is linked for: 0 (A) or 1 (B), an update goes to the other one
+#ifndef CFG_FIRMWARE_SLOT
+#define CFG_FIRMWARE_SLOT       0
+#endif
+
+// While suspended the free slot is erased at most a sector per this interval, keeping the
+// average current near the suspend budget
+#ifndef CFG_UPDATE_SUSPEND_ERASE_MS
+#define CFG_UPDATE_SUSPEND_ERASE_MS 1000
+#endif
+
+// An image transfer stalled for this long is abandoned and the console takes CDC back
+#ifndef CFG_UPDATE_TIMEOUT_MS
+#define CFG_UPDATE_TIMEOUT_MS   2000
+#endif
+
+// Bytes of a received image checked per main loop iteration
+#ifndef CFG_UPDATE_VERIFY_CHUNK
+#define CFG_UPDATE_VERIFY_CHUNK 4096
+#endif
+
+//------------- CRC -------------//
+
+// Shortest buffer checksummed by the DMA sniffer, below it the table is faster than the setup
+#ifndef CFG_CRC_DMA_MIN
+#define CFG_CRC_DMA_MIN         64
+#endif
+
+// Buffer size of the "crc" benchmark
+#ifndef CFG_CRC_BENCH_SIZE
+#define CFG_CRC_BENCH_SIZE      2048
+#endif
+
+//------------- Binary log -------------//
+
+// Words in the RAM ring of BINLOG() records (power of 2), a record takes 2 + arguments
+#ifndef CFG_BINLOG_WORDS
+#define CFG_BINLOG_WORDS        1024
+#endif
+
+//------------- CDC throughput -------------//
+
+// Least free space in the CDC TX FIFO the throughput benchmark waits for before it writes all
+// there is, at most half the FIFO so the bulk endpoint never runs dry between writes
+#ifndef CFG_CDC_STREAM_CHUNK
+#define CFG_CDC_STREAM_CHUNK    256
+#endif
+
+#endif /* APP_CONFIG_H_ */
@@ -0,0 +1,90 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef APP_STATE_H_
+#define APP_STATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Run-time state of the application, one block per subsystem.
+ *
+ * Blocks are plain data, word aligned and free of pointers, so a snapshot is a
+ * struct copy: cheap to keep across suspend or a watchdog reset, or to hand to
+ * the other core. Timestamps are board_millis() values (sof_clock_ms() for the
+ * report tick); restoring re-anchors them to the current time so a restored
+ * task neither fires a burst nor stalls.
+ * USB bus state (mounted, suspended, configuration) is taken from the stack on
+ * restore, not from the snapshot.
+ */
+
+#define APP_STATE_ALIGNED   __attribute__ ((aligned(4)))
+
+// LED blinking task
+typedef struct APP_STATE_ALIGNED
+{
+  uint32_t start_ms;           // last toggle
+  uint32_t blink_interval_ms;  // 0: blinking disabled
+  bool     led_on;
+} led_state_t;
+
+// HID report generation
+typedef struct APP_STATE_ALIGNED
+{
+  uint32_t start_ms;           // last report tick, sof_clock_ms()
+  uint32_t motion_accum;       // fractional demo motion, counts * 1000
+  uint8_t  active_config;      // CONFIG_LOW_POWER or CONFIG_HIGH_RATE
+  bool     mounted;            // cleared by unmount only, a bus reset leaves it set
+  uint32_t reports_queued;     // motion reports generated since cold boot
+
+  // bus suspend
+  bool     suspended;          // report generation is paused
+  bool     remote_wakeup_en;   // host allowed remote wakeup for this suspend
+  bool     wake_queued;        // wake report queued, waiting for resume
+
+  // a key was reported pressed, the release report is still owed
+  bool     has_keyboard_key;
+  bool     has_consumer_key;
+  bool     has_gamepad_key;
+} hid_state_t;
+
+typedef struct APP_STATE_ALIGNED
+{
+  led_state_t led;
+  hid_state_t hid;
+} app_state_t;
+
+void app_state_snapshot(app_state_t* snap);
+void app_state_restore(app_state_t const* snap);
+
+// main() is app_init() followed by app_task() forever. A host build (host/) drives them itself.
+void app_init(void);
+void app_task(void);   // one main loop iteration
+
+// board_millis() by which app_task() must run again, for a host build that jumps
+// virtual time from deadline to deadline. USB events come on top.
+uint32_t app_next_deadline_ms(void);
+
+#endif /* APP_STATE_H_ */
@@ -0,0 +1,137 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "hardware/timer.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "binlog.h"
+#include "console.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+TU_VERIFY_STATIC((CFG_BINLOG_WORDS & (CFG_BINLOG_WORDS - 1)) == 0, "ring size must be a power of 2");
+
+// Record: header, timestamp, arguments
+#define RECORD_WORDS_MAX  (2 + BINLOG_MAX_ARGS)
+
+// Single producer (binlog_write), single consumer (binlog_task), indexes run freely
+static uint32_t ring[CFG_BINLOG_WORDS];
+static uint32_t head;
+static uint32_t tail;
+
+static struct
+{
+  uint32_t records;
+  uint32_t dropped;    // ring full
+  uint32_t max_used;   // words
+  bool     draining;
+  bool     follow;     // keep draining once the ring is empty
+} blog;
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void __hot_path_func(binlog_write)(uint32_t id, uint32_t const* args, uint32_t count)
+{
+  uint32_t const used = head - tail;
+  if ( used + 2 + count > CFG_BINLOG_WORDS )
+  {
+    blog.dropped++;
+    return;
+  }
+
+  uint32_t h = head;
+  ring[h++ % CFG_BINLOG_WORDS] = (id << BINLOG_ID_SHIFT) | count;
+  ring[h++ % CFG_BINLOG_WORDS] = time_us_32();
+  for ( uint32_t i = 0; i < count; i++ ) ring[h++ % CFG_BINLOG_WORDS] = args[i];
+  head = h;
+
+  blog.records++;
+  if ( used + 2 + count > blog.max_used ) blog.max_used = used + 2 + count;
+}
+
+// One record per line: '~' and its words in hex, the format tools/binlog_decode reads
+void binlog_task(void)
+{
+  if ( !blog.draining ) return;
+
+  while ( tail != head && tud_cdc_write_available() >= 8 + 9 * RECORD_WORDS_MAX )
+  {
+    uint32_t const words = 2 + (ring[tail % CFG_BINLOG_WORDS] & 0xFFu);
+    char line[4 + 9 * RECORD_WORDS_MAX];
+    int len = 0;
+
+    line[len++] = '~';
+    for ( uint32_t i = 0; i < words; i++ )
+    {
+      uint32_t const w = ring[(tail + i) % CFG_BINLOG_WORDS];
+      line[len++] = ' ';
+      for ( int shift = 28; shift >= 0; shift -= 4 ) line[len++] = "0123456789abcdef"[(w >> shift) & 0xFu];
+    }
+    line[len++] = '\r';
+    line[len++] = '\n';
+
+    tud_cdc_write(line, (uint32_t) len);
+    tail += words;
+  }
+
+  if ( tail == head && !blog.follow ) blog.draining = false;
+}
+
+bool binlog_pending(void)
+{
+  return blog.draining && tail != head;
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void binlog_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 && (!strcmp(argv[1], "dump") || !strcmp(argv[1], "follow")) )
+  {
+    blog.draining = true;
+    blog.follow = !strcmp(argv[1], "follow");
+    return;
+  }
+
+  if ( argc == 2 && !strcmp(argv[1], "stop") )
+  {
+    blog.draining = false;
+    blog.follow = false;
+    return;
+  }
+
+  console_printf("%lu records, %lu dropped, %lu/%u words pending, high-water %lu\r\n",
+                 (unsigned long) blog.records, (unsigned long) blog.dropped, (unsigned long) (head - tail),
+                 (unsigned) CFG_BINLOG_WORDS, (unsigned long) blog.max_used);
+}
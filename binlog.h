@@ -0,0 +1,82 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef BINLOG_H_
+#define BINLOG_H_
+
+#include <stdint.h>
+
+#include "app_config.h"
+
+/* Deferred-format binary log.
+ *
+ * BINLOG("fmt", args...) does not format anything. The format string is placed
+ * in the non-allocated ELF section .logfmt, which the linker puts at address 0
+ * and which never reaches flash, so the address of the string is its offset in
+ * that section and serves as its id. The call stores the id, the argument count,
+ * a timestamp and the raw arguments in a RAM ring: a few word stores.
+ *
+ * "binlog dump" (or "binlog follow") prints the ring as hex records over CDC;
+ * tools/binlog_decode reads the strings from .logfmt of the same ELF and
+ * renders them on the host.
+ *
+ * Arguments: up to BINLOG_MAX_ARGS integers, each stored as 32 bits; only
+ * integer conversions (%d %i %u %x %X %o %c %p) can be decoded, no %s.
+ * Core 0 main loop only: the ring has no lock and must not be used from
+ * interrupts.
+ */
+
+#define BINLOG_MAX_ARGS   4
+
+// Record header: id << 8 | argument count
+#define BINLOG_ID_SHIFT   8
+
+// A comment character ends the section name, so the flags GCC appends (alloc) are not seen by the assembler
+#if defined(__arm__)
+  #define BINLOG_SECTION  ".logfmt,\"\",%progbits @"
+#else
+  #define BINLOG_SECTION  ".logfmt,\"\",@progbits #"
+#endif
+
+#define BINLOG(_fmt, ...) \
+  do { \
+    static char const __attribute__((section(BINLOG_SECTION), used)) _binlog_fmt[] = _fmt; \
+    uint32_t const _binlog_args[] = { 0, ##__VA_ARGS__ }; \
+    _Static_assert(sizeof(_binlog_args) / 4 - 1 <= BINLOG_MAX_ARGS, "too many BINLOG arguments"); \
+    binlog_write((uint32_t) (uintptr_t) _binlog_fmt, _binlog_args + 1, sizeof(_binlog_args) / 4 - 1); \
+  } while ( 0 )
+
+void binlog_write(uint32_t id, uint32_t const* args, uint32_t count);
+
+// Print pending records while dumping or following, call once per main loop iteration
+void binlog_task(void);
+
+// Records are waiting for binlog_task() to print them
+bool binlog_pending(void);
+
+// Console: binlog [dump | follow | stop]
+void binlog_cmd(int argc, char* argv[]);
+
+#endif /* BINLOG_H_ */
@@ -0,0 +1,88 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/* Boot stage: the program at the start of flash, behind boot2.
+ *
+ * The RP2040 boot ROM only starts the image at the start of flash, and XIP has
+ * no address translation, so the firmware is built twice, linked for slot A and
+ * for slot B. This stage starts the slot the newest boot record names, or the
+ * other one if that slot does not hold a plausible image, so an update is
+ * switched to by one atomic record write (boot_record.h) and never copied.
+ * It writes no flash and is not replaced by updates.
+ */
+
+#include "pico/bootrom.h"
+#include "hardware/irq.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/systick.h"
+
+#include "boot_record.h"
+
+// Every image starts with its own boot2, the vector table follows
+#define VECTORS_OFFSET  0x100
+
+static uint32_t const* slot_vectors(uint32_t slot)
+{
+  return (uint32_t const*) (uintptr_t) (XIP_BASE + FLASH_SLOT_OFFSET(slot) + VECTORS_OFFSET);
+}
+
+// Initial stack pointer in SRAM, reset handler (Thumb) in the slot: linked for this slot
+static bool slot_plausible(uint32_t slot)
+{
+  uint32_t const* vectors = slot_vectors(slot);
+  uint32_t const sp = vectors[0];
+  uint32_t const reset = vectors[1];
+  uint32_t const start = XIP_BASE + FLASH_SLOT_OFFSET(slot);
+
+  return sp > SRAM_BASE && sp <= SRAM_END && (sp & 3) == 0 &&
+         (reset & 1) && reset - start < FLASH_SLOT_SIZE;
+}
+
+// Start an image as boot2 would: its vector table, stack and reset handler
+static void __attribute__((noreturn)) start_slot(uint32_t slot)
+{
+  uint32_t const* vectors = slot_vectors(slot);
+
+  // leave nothing of this program's runtime armed, the image sets up its own
+  systick_hw->csr = 0;
+  irq_set_mask_enabled(0xFFFFFFFFu, false);
+
+  scb_hw->vtor = (uintptr_t) vectors;
+  __asm volatile ("msr msp, %0\n"
+                  "bx %1\n" : : "r" (vectors[0]), "r" (vectors[1]));
+  __builtin_unreachable();
+}
+
+int main(void)
+{
+  uint32_t const slot = boot_record_slot();
+
+  if ( slot_plausible(slot) ) start_slot(slot);
+  if ( slot_plausible(slot ^ 1) ) start_slot(slot ^ 1);
+
+  // no image at all: wait for one over BOOTSEL
+  reset_usb_boot(0, 0);
+}
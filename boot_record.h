@@ -0,0 +1,94 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef BOOT_RECORD_H_
+#define BOOT_RECORD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "flash_layout.h"
+
+/* Boot record: which firmware slot the boot stage starts.
+ *
+ * Records are appended to two sectors at FLASH_BOOT_RECORD_OFFSET, the valid one
+ * with the highest sequence number wins. Selecting a slot is a single 8 byte
+ * record write, so it either happened or not: a write cut short leaves bits of
+ * the value and of its complement unprogrammed, the pair no longer matches and
+ * the previous record stays in force. When a sector is full the other one is
+ * erased and written from its start, the newest record is never erased.
+ *
+ * The reader is inline so that the boot stage, which links nothing else of the
+ * firmware, shares it with update.c, the writer.
+ */
+
+typedef struct
+{
+  uint32_t value;     // sequence number << 1 | slot
+  uint32_t inverse;   // ~value
+} boot_record_t;
+
+#define BOOT_RECORDS    (FLASH_BOOT_RECORD_SIZE / sizeof(boot_record_t))
+
+static inline boot_record_t const* boot_record_at(uint32_t index)
+{
+  return (boot_record_t const*) (uintptr_t) (XIP_BASE + FLASH_BOOT_RECORD_OFFSET) + index;
+}
+
+static inline bool boot_record_valid(boot_record_t const* rec)
+{
+  return rec->value == ~rec->inverse;
+}
+
+static inline bool boot_record_erased(boot_record_t const* rec)
+{
+  return rec->value == 0xFFFFFFFFu && rec->inverse == 0xFFFFFFFFu;
+}
+
+// Index of the newest valid record, -1 if there is none (slot A is started then)
+static inline int32_t boot_record_newest(void)
+{
+  int32_t newest = -1;
+
+  for ( uint32_t i = 0; i < BOOT_RECORDS; i++ )
+  {
+    boot_record_t const* rec = boot_record_at(i);
+    if ( boot_record_valid(rec) && (newest < 0 || rec->value >> 1 > boot_record_at(newest)->value >> 1) )
+    {
+      newest = (int32_t) i;
+    }
+  }
+
+  return newest;
+}
+
+// Slot the boot stage starts when its image looks sane
+static inline uint32_t boot_record_slot(void)
+{
+  int32_t const newest = boot_record_newest();
+  return newest < 0 ? 0 : boot_record_at(newest)->value & 1;
+}
+
+#endif /* BOOT_RECORD_H_ */
@@ -0,0 +1,139 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hardware/timer.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "cdc_stream.h"
+#include "console.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define SOURCE_SIZE   4096
+
+TU_VERIFY_STATIC(CFG_CDC_STREAM_CHUNK <= CFG_TUD_CDC_TX_BUFSIZE / 2, "a chunk must leave the FIFO half full");
+
+typedef struct
+{
+  bool     active;
+  uint32_t total;
+  uint32_t sent;
+  uint32_t offset;      // read position in source
+  uint32_t start_us;
+  uint32_t cpu_us;      // time spent inside cdc_stream_task()
+} stream_state_t;
+
+static stream_state_t stream;
+
+static uint32_t source[SOURCE_SIZE / 4];
+
+static void stream_finish(char const* why)
+{
+  stream.active = false;
+
+  uint32_t const elapsed = time_us_32() - stream.start_us;
+
+  console_printf("\r\nstream %s: %lu bytes in %lu us, %lu KB/s, CPU %lu us (%lu%%)\r\n", why,
+                 (unsigned long) stream.sent, (unsigned long) elapsed,
+                 (unsigned long) (elapsed ? (uint64_t) stream.sent * 1000 / elapsed : 0),
+                 (unsigned long) stream.cpu_us,
+                 (unsigned long) (elapsed ? (uint64_t) stream.cpu_us * 100 / elapsed : 0));
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void cdc_stream_task(void)
+{
+  if ( !stream.active ) return;
+
+  uint32_t const t0 = time_us_32();
+
+  if ( !tud_cdc_connected() )
+  {
+    stream_finish("aborted");
+    return;
+  }
+
+  // top the FIFO up while packets from the other half are still going out: straight from the
+  // source into the CDC FIFO, TinyUSB copies it on to the endpoint
+  uint32_t room = tud_cdc_write_available();
+  while ( room >= CFG_CDC_STREAM_CHUNK && stream.sent < stream.total )
+  {
+    uint32_t const n = tu_min32(tu_min32(room, stream.total - stream.sent), SOURCE_SIZE - stream.offset);
+
+    tud_cdc_write((uint8_t const*) source + stream.offset, n);
+    stream.offset = (stream.offset + n) % SOURCE_SIZE;
+    stream.sent += n;
+    room -= n;
+  }
+  tud_cdc_write_flush();
+
+  stream.cpu_us += time_us_32() - t0;
+  if ( stream.sent >= stream.total ) stream_finish("done");
+}
+
+bool cdc_stream_active(void)
+{
+  return stream.active;
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void cdc_stream_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 && !strcmp(argv[1], "stop") )
+  {
+    if ( stream.active ) stream_finish("stopped");
+    return;
+  }
+
+  long const kbytes = (argc == 2) ? strtol(argv[1], NULL, 0) : 0;
+
+  if ( argc != 2 || kbytes <= 0 || kbytes > 1024 * 1024 )
+  {
+    console_printf("usage: stream <kbytes> | stream stop\r\n");
+    return;
+  }
+
+  if ( stream.active ) return;
+
+  // recognisable pattern: little-endian word counter
+  for ( uint32_t i = 0; i < TU_ARRAY_SIZE(source); i++ ) source[i] = i;
+
+  memset(&stream, 0, sizeof(stream));
+  stream.total = (uint32_t) kbytes * 1024;
+  stream.start_us = time_us_32();
+  stream.active = true;
+}
@@ -0,0 +1,45 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef CDC_STREAM_H_
+#define CDC_STREAM_H_
+
+#include <stdbool.h>
+
+/* CDC bulk IN throughput benchmark.
+ *
+ * "stream <kbytes>" sends a test pattern from a source buffer straight into
+ * the CDC FIFO, while the main loop keeps generating reports. At the end it
+ * prints the throughput and the CPU time spent in the stream task. Read the data on the host with e.g.
+ * "cat /dev/ttyACM0 > /dev/null".
+ */
+
+void cdc_stream_task(void);
+bool cdc_stream_active(void);
+
+// Console: stream <kbytes> | stream stop
+void cdc_stream_cmd(int argc, char* argv[]);
+
+#endif /* CDC_STREAM_H_ */
@@ -0,0 +1,340 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tusb.h"
+
+#include "hardware/timer.h"
+
+#include "app_config.h"
+#include "cdc_stream.h"
+#include "console.h"
+#include "core1_load.h"
+#include "motion.h"
+#include "perf.h"
+#include "power.h"
+#include "reset_policy.h"
+#include "recovery.h"
+#include "kv.h"
+#include "flash_service.h"
+#include "event_log.h"
+#include "update.h"
+#include "crc.h"
+#include "binlog.h"
+#include "usb_stats.h"
+#include "stress.h"
+#include "sof_clock.h"
+#include "pool.h"
+
+// generated from console_cmds.def
+#include "cmd_hash.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define CONSOLE_MAX_ARGS  8
+
+// Command line, allocated when its first byte arrives
+typedef struct console_line
+{
+  struct console_line* next;
+  uint8_t len;
+  char text[CFG_CONSOLE_LINE_MAX];
+} console_line_t;
+
+POOL_DEFINE(line_pool, console_line_t, CFG_POOL_COMMANDS);
+
+static console_line_t* rx_line;       // line being received
+static console_line_t* pending_head;  // complete lines waiting to run
+static console_line_t* pending_tail;
+static bool rx_dropped;               // bytes were lost, pool exhausted or line too long
+
+static void cmd_help(int argc, char* argv[]);
+static void cmd_pools(int argc, char* argv[]);
+static void cmd_dispatch(int argc, char* argv[]);
+
+// Indexed by console_cmd_id_t
+static console_cmd_t const commands[CMD_COUNT] =
+{
+#define CONSOLE_CMD(_id, _name, _handler, _help) [CMD_##_id] = { #_name, _handler, _help },
+#include "console_cmds.def"
+#undef CONSOLE_CMD
+};
+
+TU_VERIFY_STATIC(CMD_HASH_SIZE == CMD_COUNT, "cmd_hash.h is stale, rebuild");
+
+//--------------------------------------------------------------------+
+// Output
+//--------------------------------------------------------------------+
+
+void console_printf(char const* fmt, ...)
+{
+  if ( !tud_cdc_connected() ) return;
+
+  char buf[128];
+  va_list ap;
+  va_start(ap, fmt);
+  int len = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+
+  if ( len <= 0 ) return;
+  if ( len >= (int) sizeof(buf) ) len = sizeof(buf) - 1;
+
+  tud_cdc_write(buf, (uint32_t) len);
+}
+
+//--------------------------------------------------------------------+
+// Built-in commands
+//--------------------------------------------------------------------+
+
+static void cmd_help(int argc, char* argv[])
+{
+  (void) argc;
+  (void) argv;
+
+  for ( size_t i = 0; i < TU_ARRAY_SIZE(commands); i++ )
+  {
+    console_printf("%-8s %s\r\n", commands[i].name, commands[i].help);
+  }
+}
+
+static void print_pool(pool_t const* pool, void* arg)
+{
+  (void) arg;
+  console_printf("%-12s %3u/%-3u used, high-water %u, %lu acquired, %lu failed",
+                 pool->name, pool->used, pool->capacity, pool->high_water,
+                 (unsigned long) pool->acquired, (unsigned long) pool->failed);
+  if ( pool->bad_releases ) console_printf(", %lu bad releases", (unsigned long) pool->bad_releases);
+  console_printf("\r\n");
+}
+
+static void cmd_pools(int argc, char* argv[])
+{
+  (void) argc;
+  (void) argv;
+  pool_foreach(print_pool, NULL);
+}
+
+//--------------------------------------------------------------------+
+// Dispatch
+//--------------------------------------------------------------------+
+
+// FNV-1a with the high half folded in, must match fnv1a() in tools/gen_cmd_hash.py
+static inline uint32_t cmd_hash(char const* name, uint32_t seed)
+{
+  uint32_t h = 0x811C9DC5u ^ seed;
+  while ( *name ) h = (h ^ (uint8_t) *name++) * 0x01000193u;
+  return h ^ (h >> 16);
+}
+
+int console_cmd_find(char const* name)
+{
+  uint32_t const bucket = cmd_hash(name, 0) % CMD_HASH_BUCKETS;
+  uint8_t const id = cmd_hash_slot[cmd_hash(name, cmd_hash_displace[bucket]) % CMD_HASH_SIZE];
+
+  // any string hashes to some slot, only the name stored there is a match
+  return strcmp(name, commands[id].name) ? -1 : id;
+}
+
+// The lookup the hash replaced, for comparison
+static int find_linear(char const* name)
+{
+  for ( int i = 0; i < CMD_COUNT; i++ )
+  {
+    if ( !strcmp(name, commands[i].name) ) return i;
+  }
+  return -1;
+}
+
+static void run_line(char* text)
+{
+  char* argv[CONSOLE_MAX_ARGS];
+  int argc = 0;
+
+  for ( char* tok = strtok(text, " \t"); tok && argc < CONSOLE_MAX_ARGS; tok = strtok(NULL, " \t") )
+  {
+    argv[argc++] = tok;
+  }
+
+  if ( argc == 0 ) return;
+
+  int const id = console_cmd_find(argv[0]);
+  if ( id < 0 )
+  {
+    console_printf("unknown command '%s', try help\r\n", argv[0]);
+    return;
+  }
+
+  commands[id].handler(argc, argv);
+}
+
+// Time looking up every command name and a miss, with the hash and with a linear search
+static void cmd_dispatch(int argc, char* argv[])
+{
+  (void) argc;
+  (void) argv;
+
+  enum { ROUNDS = 200 };
+  static char const* const misses[] = { "nosuch", "x" };
+  static int (* const lookups[])(char const*) = { console_cmd_find, find_linear };
+  static char const* const lookup_names[] = { "hash", "linear" };
+
+  for ( size_t l = 0; l < TU_ARRAY_SIZE(lookups); l++ )
+  {
+    volatile int sink = 0;
+    uint32_t const start = time_us_32();
+
+    for ( int r = 0; r < ROUNDS; r++ )
+    {
+      for ( int i = 0; i < CMD_COUNT; i++ ) sink += lookups[l](commands[i].name);
+      for ( size_t i = 0; i < TU_ARRAY_SIZE(misses); i++ ) sink += lookups[l](misses[i]);
+    }
+
+    uint32_t const us = time_us_32() - start;
+    uint32_t const count = ROUNDS * (CMD_COUNT + TU_ARRAY_SIZE(misses));
+    console_printf("%-6s %lu lookups in %lu us, %lu ns each\r\n", lookup_names[l], (unsigned long) count,
+                   (unsigned long) us, (unsigned long) (us * 1000u / count));
+  }
+}
+
+static void receive(uint8_t const* buf, uint32_t count)
+{
+  for ( uint32_t i = 0; i < count; i++ )
+  {
+    char const ch = (char) buf[i];
+
+    if ( ch == '\r' || ch == '\n' )
+    {
+      if ( rx_line && rx_line->len )
+      {
+        rx_line->text[rx_line->len] = 0;
+        rx_line->next = NULL;
+
+        if ( pending_tail ) pending_tail->next = rx_line;
+        else pending_head = rx_line;
+        pending_tail = rx_line;
+        rx_line = NULL;
+      }
+
+      if ( rx_dropped ) console_printf("\r\nconsole busy, line dropped\r\n");
+      rx_dropped = false;
+      continue;
+    }
+
+    if ( rx_dropped ) continue;
+
+    if ( !rx_line )
+    {
+      rx_line = line_pool_acquire();
+      if ( !rx_line )
+      {
+        rx_dropped = true;
+        continue;
+      }
+      rx_line->len = 0;
+    }
+
+    if ( rx_line->len < CFG_CONSOLE_LINE_MAX - 1 )
+    {
+      rx_line->text[rx_line->len++] = ch;
+    }else
+    {
+      // overlong line: discard it entirely rather than run a truncated command
+      line_pool_release(rx_line);
+      rx_line = NULL;
+      rx_dropped = true;
+    }
+  }
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void console_init(void)
+{
+  pool_register(&line_pool);
+}
+
+uint32_t console_flush(void)
+{
+  uint32_t count = 0;
+
+  if ( rx_line )
+  {
+    line_pool_release(rx_line);
+    rx_line = NULL;
+    count++;
+  }
+  rx_dropped = false;
+
+  while ( pending_head )
+  {
+    console_line_t* next = pending_head->next;
+    line_pool_release(pending_head);
+    pending_head = next;
+    count++;
+  }
+  pending_tail = NULL;
+
+  return count;
+}
+
+bool console_pending(void)
+{
+  return pending_head != NULL;
+}
+
+void console_task(void)
+{
+  // during an update the CDC data is the image
+  if ( !update_receiving() && tud_cdc_connected() && tud_cdc_available() )
+  {
+    uint8_t buf[64];
+    uint32_t count = tud_cdc_read(buf, sizeof(buf));
+
+    // echo, so a plain terminal shows what is typed
+    tud_cdc_write(buf, count);
+    receive(buf, count);
+  }
+
+  // one command per call keeps the main loop latency bounded
+  console_line_t* line = pending_head;
+  if ( line )
+  {
+    pending_head = line->next;
+    if ( !pending_head ) pending_tail = NULL;
+
+    console_printf("\r\n");
+    run_line(line->text);
+    line_pool_release(line);
+  }
+
+  tud_cdc_write_flush();
+}
@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Line oriented command console on the CDC interface.
+ *
+ * Received bytes are echoed back. Each line (terminated by CR or LF) is split
+ * into whitespace separated arguments and dispatched by its first word. Lines
+ * are pool allocated and at most one command runs per console_task() call.
+ *
+ * The commands are declared once in console_cmds.def. The first word is looked
+ * up in a minimal perfect hash of the names generated from it at build time
+ * (tools/gen_cmd_hash.py), so dispatch costs one hash and one strcmp() however
+ * many commands there are.
+ */
+
+typedef struct
+{
+  char const* name;
+  void (*handler)(int argc, char* argv[]);
+  char const* help;
+} console_cmd_t;
+
+typedef enum
+{
+#define CONSOLE_CMD(_id, _name, _handler, _help) CMD_##_id,
+#include "console_cmds.def"
+#undef CONSOLE_CMD
+  CMD_COUNT
+} console_cmd_id_t;
+
+void console_init(void);
+void console_task(void);
+
+// Id of the command called 'name', -1 if there is none
+int console_cmd_find(char const* name);
+
+// Drop the line being received and the lines waiting to run, return how many were dropped
+uint32_t console_flush(void);
+
+// Complete lines are waiting to run
+bool console_pending(void);
+
+// Formatted output to the CDC interface, dropped if no terminal is connected
+void console_printf(char const* fmt, ...) __attribute__ ((format (printf, 1, 2)));
+
+#endif /* CONSOLE_H_ */
@@ -0,0 +1,135 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "pico/flash.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "console.h"
+#include "core1_load.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define STRIPED_WORDS   2048  // 8 KB per buffer
+#define SCRATCH_WORDS   64
+
+#define CORE1_PARKED          0x50415244u  // "PARK", core 1 left the flash lockout
+#define CORE1_PARK_TIMEOUT_US 1000         // a pass is well under this, even striped
+
+static uint32_t striped_buf[2][STRIPED_WORDS];
+static uint32_t __scratch_y("core1_load") scratch_buf[SCRATCH_WORDS];
+
+static volatile core1_load_t load_mode;
+static volatile uint32_t load_passes;
+static bool core1_running;
+
+static char const* const mode_names[] = { "off", "striped", "scratch" };
+
+//--------------------------------------------------------------------+
+// Core 1
+//--------------------------------------------------------------------+
+
+// Runs from SRAM so that the load is on the SRAM banks, not on XIP
+static void __not_in_flash_func(core1_entry)(void)
+{
+  // let flash_safe_execute() on core 0 park this core while flash is written
+  flash_safe_execute_core_init();
+
+  while ( load_mode != LOAD_OFF )
+  {
+    if ( load_mode == LOAD_STRIPED )
+    {
+      memcpy(striped_buf[1], striped_buf[0], sizeof(striped_buf[0]));
+    }else
+    {
+      for ( uint32_t i = 0; i < SCRATCH_WORDS; i++ ) scratch_buf[i] += i;
+    }
+
+    load_passes++;
+  }
+
+  // Leave the lockout before core 0 resets this core: a reset core stays registered but never
+  // answers, and every later flash_safe_execute() would time out waiting for it
+  flash_safe_execute_core_deinit();
+  multicore_fifo_push_blocking(CORE1_PARKED);
+
+  while ( 1 ) __wfe();
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void core1_load_set(core1_load_t mode)
+{
+  load_mode = mode;
+
+  if ( mode == LOAD_OFF )
+  {
+    if ( !core1_running ) return;
+
+    // only reset core 1 once it has parked, out of the lockout. If it does not answer it is
+    // left running: it still answers the lockout, so flash writes keep working
+    uint32_t ack;
+    if ( multicore_fifo_pop_timeout_us(CORE1_PARK_TIMEOUT_US, &ack) && ack == CORE1_PARKED )
+    {
+      multicore_reset_core1();
+      core1_running = false;
+    }
+  }else if ( !core1_running )
+  {
+    load_passes = 0;
+    multicore_fifo_drain();
+    multicore_launch_core1(core1_entry);
+    core1_running = true;
+  }
+}
+
+void core1_load_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 )
+  {
+    for ( unsigned i = 0; i < TU_ARRAY_SIZE(mode_names); i++ )
+    {
+      if ( !strcmp(argv[1], mode_names[i]) )
+      {
+        core1_load_set((core1_load_t) i);
+        return;
+      }
+    }
+
+    console_printf("usage: load [off|striped|scratch]\r\n");
+    return;
+  }
+
+  console_printf("load %s, %lu passes, hot data %s\r\n", mode_names[load_mode], (unsigned long) load_passes,
+                 CFG_CORE_SRAM_PLACEMENT ? "in SCRATCH_Y" : "in main SRAM");
+}
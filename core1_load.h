@@ -0,0 +1,50 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef CORE1_LOAD_H_
+#define CORE1_LOAD_H_
+
+/* Synthetic memory load on core 1, to measure how bus contention affects core 0.
+ *
+ * - LOAD_STRIPED : copies a buffer in the striped main SRAM
+ * - LOAD_SCRATCH : hammers a buffer in SCRATCH_Y, the bank holding the core 0
+ *                  stack and (with CFG_CORE_SRAM_PLACEMENT) its hot data
+ *
+ * Compare the "perf" loop and report figures with the load off, striped and scratch.
+ */
+
+typedef enum
+{
+  LOAD_OFF = 0,
+  LOAD_STRIPED,
+  LOAD_SCRATCH,
+} core1_load_t;
+
+void core1_load_set(core1_load_t mode);
+
+// Console: load [off|striped|scratch]
+void core1_load_cmd(int argc, char* argv[]);
+
+#endif /* CORE1_LOAD_H_ */
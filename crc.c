@@ -0,0 +1,294 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "hardware/timer.h"
+#if PICO_ON_DEVICE
+#include "hardware/dma.h"
+#endif
+
+#include "app_config.h"
+#include "console.h"
+#include "crc.h"
+#if PICO_ON_DEVICE
+#include "flash_layout.h"
+#endif
+
+//--------------------------------------------------------------------+
+// Software, table driven
+//--------------------------------------------------------------------+
+
+// Reflected polynomial 0xEDB88320
+static uint32_t const crc32_table[256] =
+{
+  0x00000000u, 0x77073096u, 0xEE0E612Cu, 0x990951BAu, 0x076DC419u, 0x706AF48Fu,
+  0xE963A535u, 0x9E6495A3u, 0x0EDB8832u, 0x79DCB8A4u, 0xE0D5E91Eu, 0x97D2D988u,
+  0x09B64C2Bu, 0x7EB17CBDu, 0xE7B82D07u, 0x90BF1D91u, 0x1DB71064u, 0x6AB020F2u,
+  0xF3B97148u, 0x84BE41DEu, 0x1ADAD47Du, 0x6DDDE4EBu, 0xF4D4B551u, 0x83D385C7u,
+  0x136C9856u, 0x646BA8C0u, 0xFD62F97Au, 0x8A65C9ECu, 0x14015C4Fu, 0x63066CD9u,
+  0xFA0F3D63u, 0x8D080DF5u, 0x3B6E20C8u, 0x4C69105Eu, 0xD56041E4u, 0xA2677172u,
+  0x3C03E4D1u, 0x4B04D447u, 0xD20D85FDu, 0xA50AB56Bu, 0x35B5A8FAu, 0x42B2986Cu,
+  0xDBBBC9D6u, 0xACBCF940u, 0x32D86CE3u, 0x45DF5C75u, 0xDCD60DCFu, 0xABD13D59u,
+  0x26D930ACu, 0x51DE003Au, 0xC8D75180u, 0xBFD06116u, 0x21B4F4B5u, 0x56B3C423u,
+  0xCFBA9599u, 0xB8BDA50Fu, 0x2802B89Eu, 0x5F058808u, 0xC60CD9B2u, 0xB10BE924u,
+  0x2F6F7C87u, 0x58684C11u, 0xC1611DABu, 0xB6662D3Du, 0x76DC4190u, 0x01DB7106u,
+  0x98D220BCu, 0xEFD5102Au, 0x71B18589u, 0x06B6B51Fu, 0x9FBFE4A5u, 0xE8B8D433u,
+  0x7807C9A2u, 0x0F00F934u, 0x9609A88Eu, 0xE10E9818u, 0x7F6A0DBBu, 0x086D3D2Du,
+  0x91646C97u, 0xE6635C01u, 0x6B6B51F4u, 0x1C6C6162u, 0x856530D8u, 0xF262004Eu,
+  0x6C0695EDu, 0x1B01A57Bu, 0x8208F4C1u, 0xF50FC457u, 0x65B0D9C6u, 0x12B7E950u,
+  0x8BBEB8EAu, 0xFCB9887Cu, 0x62DD1DDFu, 0x15DA2D49u, 0x8CD37CF3u, 0xFBD44C65u,
+  0x4DB26158u, 0x3AB551CEu, 0xA3BC0074u, 0xD4BB30E2u, 0x4ADFA541u, 0x3DD895D7u,
+  0xA4D1C46Du, 0xD3D6F4FBu, 0x4369E96Au, 0x346ED9FCu, 0xAD678846u, 0xDA60B8D0u,
+  0x44042D73u, 0x33031DE5u, 0xAA0A4C5Fu, 0xDD0D7CC9u, 0x5005713Cu, 0x270241AAu,
+  0xBE0B1010u, 0xC90C2086u, 0x5768B525u, 0x206F85B3u, 0xB966D409u, 0xCE61E49Fu,
+  0x5EDEF90Eu, 0x29D9C998u, 0xB0D09822u, 0xC7D7A8B4u, 0x59B33D17u, 0x2EB40D81u,
+  0xB7BD5C3Bu, 0xC0BA6CADu, 0xEDB88320u, 0x9ABFB3B6u, 0x03B6E20Cu, 0x74B1D29Au,
+  0xEAD54739u, 0x9DD277AFu, 0x04DB2615u, 0x73DC1683u, 0xE3630B12u, 0x94643B84u,
+  0x0D6D6A3Eu, 0x7A6A5AA8u, 0xE40ECF0Bu, 0x9309FF9Du, 0x0A00AE27u, 0x7D079EB1u,
+  0xF00F9344u, 0x8708A3D2u, 0x1E01F268u, 0x6906C2FEu, 0xF762575Du, 0x806567CBu,
+  0x196C3671u, 0x6E6B06E7u, 0xFED41B76u, 0x89D32BE0u, 0x10DA7A5Au, 0x67DD4ACCu,
+  0xF9B9DF6Fu, 0x8EBEEFF9u, 0x17B7BE43u, 0x60B08ED5u, 0xD6D6A3E8u, 0xA1D1937Eu,
+  0x38D8C2C4u, 0x4FDFF252u, 0xD1BB67F1u, 0xA6BC5767u, 0x3FB506DDu, 0x48B2364Bu,
+  0xD80D2BDAu, 0xAF0A1B4Cu, 0x36034AF6u, 0x41047A60u, 0xDF60EFC3u, 0xA867DF55u,
+  0x316E8EEFu, 0x4669BE79u, 0xCB61B38Cu, 0xBC66831Au, 0x256FD2A0u, 0x5268E236u,
+  0xCC0C7795u, 0xBB0B4703u, 0x220216B9u, 0x5505262Fu, 0xC5BA3BBEu, 0xB2BD0B28u,
+  0x2BB45A92u, 0x5CB36A04u, 0xC2D7FFA7u, 0xB5D0CF31u, 0x2CD99E8Bu, 0x5BDEAE1Du,
+  0x9B64C2B0u, 0xEC63F226u, 0x756AA39Cu, 0x026D930Au, 0x9C0906A9u, 0xEB0E363Fu,
+  0x72076785u, 0x05005713u, 0x95BF4A82u, 0xE2B87A14u, 0x7BB12BAEu, 0x0CB61B38u,
+  0x92D28E9Bu, 0xE5D5BE0Du, 0x7CDCEFB7u, 0x0BDBDF21u, 0x86D3D2D4u, 0xF1D4E242u,
+  0x68DDB3F8u, 0x1FDA836Eu, 0x81BE16CDu, 0xF6B9265Bu, 0x6FB077E1u, 0x18B74777u,
+  0x88085AE6u, 0xFF0F6A70u, 0x66063BCAu, 0x11010B5Cu, 0x8F659EFFu, 0xF862AE69u,
+  0x616BFFD3u, 0x166CCF45u, 0xA00AE278u, 0xD70DD2EEu, 0x4E048354u, 0x3903B3C2u,
+  0xA7672661u, 0xD06016F7u, 0x4969474Du, 0x3E6E77DBu, 0xAED16A4Au, 0xD9D65ADCu,
+  0x40DF0B66u, 0x37D83BF0u, 0xA9BCAE53u, 0xDEBB9EC5u, 0x47B2CF7Fu, 0x30B5FFE9u,
+  0xBDBDF21Cu, 0xCABAC28Au, 0x53B39330u, 0x24B4A3A6u, 0xBAD03605u, 0xCDD70693u,
+  0x54DE5729u, 0x23D967BFu, 0xB3667A2Eu, 0xC4614AB8u, 0x5D681B02u, 0x2A6F2B94u,
+  0xB40BBE37u, 0xC30C8EA1u, 0x5A05DF1Bu, 0x2D02EF8Du,
+};
+
+// Polynomial 0x1021
+static uint16_t const crc16_table[256] =
+{
+  0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+  0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu,
+  0x1231u, 0x0210u, 0x3273u, 0x2252u, 0x52B5u, 0x4294u, 0x72F7u, 0x62D6u,
+  0x9339u, 0x8318u, 0xB37Bu, 0xA35Au, 0xD3BDu, 0xC39Cu, 0xF3FFu, 0xE3DEu,
+  0x2462u, 0x3443u, 0x0420u, 0x1401u, 0x64E6u, 0x74C7u, 0x44A4u, 0x5485u,
+  0xA56Au, 0xB54Bu, 0x8528u, 0x9509u, 0xE5EEu, 0xF5CFu, 0xC5ACu, 0xD58Du,
+  0x3653u, 0x2672u, 0x1611u, 0x0630u, 0x76D7u, 0x66F6u, 0x5695u, 0x46B4u,
+  0xB75Bu, 0xA77Au, 0x9719u, 0x8738u, 0xF7DFu, 0xE7FEu, 0xD79Du, 0xC7BCu,
+  0x48C4u, 0x58E5u, 0x6886u, 0x78A7u, 0x0840u, 0x1861u, 0x2802u, 0x3823u,
+  0xC9CCu, 0xD9EDu, 0xE98Eu, 0xF9AFu, 0x8948u, 0x9969u, 0xA90Au, 0xB92Bu,
+  0x5AF5u, 0x4AD4u, 0x7AB7u, 0x6A96u, 0x1A71u, 0x0A50u, 0x3A33u, 0x2A12u,
+  0xDBFDu, 0xCBDCu, 0xFBBFu, 0xEB9Eu, 0x9B79u, 0x8B58u, 0xBB3Bu, 0xAB1Au,
+  0x6CA6u, 0x7C87u, 0x4CE4u, 0x5CC5u, 0x2C22u, 0x3C03u, 0x0C60u, 0x1C41u,
+  0xEDAEu, 0xFD8Fu, 0xCDECu, 0xDDCDu, 0xAD2Au, 0xBD0Bu, 0x8D68u, 0x9D49u,
+  0x7E97u, 0x6EB6u, 0x5ED5u, 0x4EF4u, 0x3E13u, 0x2E32u, 0x1E51u, 0x0E70u,
+  0xFF9Fu, 0xEFBEu, 0xDFDDu, 0xCFFCu, 0xBF1Bu, 0xAF3Au, 0x9F59u, 0x8F78u,
+  0x9188u, 0x81A9u, 0xB1CAu, 0xA1EBu, 0xD10Cu, 0xC12Du, 0xF14Eu, 0xE16Fu,
+  0x1080u, 0x00A1u, 0x30C2u, 0x20E3u, 0x5004u, 0x4025u, 0x7046u, 0x6067u,
+  0x83B9u, 0x9398u, 0xA3FBu, 0xB3DAu, 0xC33Du, 0xD31Cu, 0xE37Fu, 0xF35Eu,
+  0x02B1u, 0x1290u, 0x22F3u, 0x32D2u, 0x4235u, 0x5214u, 0x6277u, 0x7256u,
+  0xB5EAu, 0xA5CBu, 0x95A8u, 0x8589u, 0xF56Eu, 0xE54Fu, 0xD52Cu, 0xC50Du,
+  0x34E2u, 0x24C3u, 0x14A0u, 0x0481u, 0x7466u, 0x6447u, 0x5424u, 0x4405u,
+  0xA7DBu, 0xB7FAu, 0x8799u, 0x97B8u, 0xE75Fu, 0xF77Eu, 0xC71Du, 0xD73Cu,
+  0x26D3u, 0x36F2u, 0x0691u, 0x16B0u, 0x6657u, 0x7676u, 0x4615u, 0x5634u,
+  0xD94Cu, 0xC96Du, 0xF90Eu, 0xE92Fu, 0x99C8u, 0x89E9u, 0xB98Au, 0xA9ABu,
+  0x5844u, 0x4865u, 0x7806u, 0x6827u, 0x18C0u, 0x08E1u, 0x3882u, 0x28A3u,
+  0xCB7Du, 0xDB5Cu, 0xEB3Fu, 0xFB1Eu, 0x8BF9u, 0x9BD8u, 0xABBBu, 0xBB9Au,
+  0x4A75u, 0x5A54u, 0x6A37u, 0x7A16u, 0x0AF1u, 0x1AD0u, 0x2AB3u, 0x3A92u,
+  0xFD2Eu, 0xED0Fu, 0xDD6Cu, 0xCD4Du, 0xBDAAu, 0xAD8Bu, 0x9DE8u, 0x8DC9u,
+  0x7C26u, 0x6C07u, 0x5C64u, 0x4C45u, 0x3CA2u, 0x2C83u, 0x1CE0u, 0x0CC1u,
+  0xEF1Fu, 0xFF3Eu, 0xCF5Du, 0xDF7Cu, 0xAF9Bu, 0xBFBAu, 0x8FD9u, 0x9FF8u,
+  0x6E17u, 0x7E36u, 0x4E55u, 0x5E74u, 0x2E93u, 0x3EB2u, 0x0ED1u, 0x1EF0u,
+};
+
+static uint32_t crc32_soft(uint32_t crc, void const* data, size_t len)
+{
+  uint8_t const* p = (uint8_t const*) data;
+
+  crc = ~crc;
+  while ( len-- ) crc = crc32_table[(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+
+  return ~crc;
+}
+
+static uint16_t crc16_soft(uint16_t crc, void const* data, size_t len)
+{
+  uint8_t const* p = (uint8_t const*) data;
+
+  while ( len-- ) crc = (uint16_t) (crc16_table[((crc >> 8) ^ *p++) & 0xFFu] ^ (crc << 8));
+
+  return crc;
+}
+
+//--------------------------------------------------------------------+
+// DMA sniffer
+//--------------------------------------------------------------------+
+
+#if PICO_ON_DEVICE
+
+static int channel = -1;
+
+// The sniffer works MSB first, the reflected CRC-32 state is its bit reversal
+static uint32_t reverse32(uint32_t x)
+{
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+  x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+// Run the data through the sniffer. The accumulator is written raw; reverse and
+// invert only apply to what is read back.
+static uint32_t sniff(uint mode, bool reverse_invert, uint32_t seed, void const* data, size_t len)
+{
+  static uint32_t sink;
+
+  dma_channel_config cfg = dma_channel_get_default_config((uint) channel);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, false);
+  channel_config_set_sniff_enable(&cfg, true);
+
+  dma_sniffer_enable((uint) channel, mode, true);
+  dma_sniffer_set_output_reverse_enabled(reverse_invert);
+  dma_sniffer_set_output_invert_enabled(reverse_invert);
+  dma_sniffer_set_data_accumulator(seed);
+
+  dma_channel_configure((uint) channel, &cfg, &sink, data, len, true);
+  dma_channel_wait_for_finish_blocking((uint) channel);
+
+  uint32_t const result = dma_sniffer_get_data_accumulator();
+  dma_sniffer_disable();
+  return result;
+}
+
+// Bit-reversed data in, result reversed and inverted out: CRC-32 as zlib computes it
+static uint32_t crc32_dma(uint32_t crc, void const* data, size_t len)
+{
+  return sniff(DMA_SNIFF_CTRL_CALC_VALUE_CRC32R, true, reverse32(~crc), data, len);
+}
+
+static uint16_t crc16_dma(uint16_t crc, void const* data, size_t len)
+{
+  return (uint16_t) sniff(DMA_SNIFF_CTRL_CALC_VALUE_CRC16, false, crc, data, len);
+}
+
+#endif
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void crc_init(void)
+{
+#if PICO_ON_DEVICE
+  if ( channel < 0 ) channel = dma_claim_unused_channel(true);
+#endif
+}
+
+uint32_t crc32_update(uint32_t crc, void const* data, size_t len)
+{
+#if PICO_ON_DEVICE
+  if ( channel >= 0 && len >= CFG_CRC_DMA_MIN ) return crc32_dma(crc, data, len);
+#endif
+  return crc32_soft(crc, data, len);
+}
+
+uint16_t crc16_update(uint16_t crc, void const* data, size_t len)
+{
+#if PICO_ON_DEVICE
+  if ( channel >= 0 && len >= CFG_CRC_DMA_MIN ) return crc16_dma(crc, data, len);
+#endif
+  return crc16_soft(crc, data, len);
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  char const* name;
+  uint32_t (*fn)(void const* data, size_t len);
+} crc_impl_t;
+
+static uint32_t bench_crc32_soft(void const* data, size_t len) { return crc32_soft(0, data, len); }
+static uint32_t bench_crc16_soft(void const* data, size_t len) { return crc16_soft(0, data, len); }
+#if PICO_ON_DEVICE
+static uint32_t bench_crc32_dma(void const* data, size_t len) { return crc32_dma(0, data, len); }
+static uint32_t bench_crc16_dma(void const* data, size_t len) { return crc16_dma(0, data, len); }
+#endif
+
+// Pairs computing the same CRC, software first
+static crc_impl_t const impls[] =
+{
+  { "crc32 table", bench_crc32_soft },
+#if PICO_ON_DEVICE
+  { "crc32 dma",   bench_crc32_dma  },
+#endif
+  { "crc16 table", bench_crc16_soft },
+#if PICO_ON_DEVICE
+  { "crc16 dma",   bench_crc16_dma  },
+#endif
+};
+
+static void bench(char const* where, void const* data, size_t len)
+{
+  uint32_t reference = 0;
+
+  for ( size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++ )
+  {
+    // the first run warms the XIP cache for flash data, time the second
+    impls[i].fn(data, len);
+    uint32_t const start = time_us_32();
+    uint32_t const crc = impls[i].fn(data, len);
+    uint32_t const us = time_us_32() - start;
+
+    bool const software = !strstr(impls[i].name, "dma");
+    if ( software ) reference = crc;
+
+    console_printf("%-5s %-11s %08lx %6lu us %6lu KB/s%s\r\n", where, impls[i].name, (unsigned long) crc,
+                   (unsigned long) us, (unsigned long) (us ? (uint64_t) len * 1000u / us : 0),
+                   software || crc == reference ? "" : " MISMATCH");
+  }
+}
+
+void crc_cmd(int argc, char* argv[])
+{
+  (void) argc;
+  (void) argv;
+
+  static uint8_t ram_buf[CFG_CRC_BENCH_SIZE];
+  for ( size_t i = 0; i < sizeof(ram_buf); i++ ) ram_buf[i] = (uint8_t) (i * 31u + 7u);
+
+  bench("ram", ram_buf, sizeof(ram_buf));
+#if PICO_ON_DEVICE
+  bench("flash", FLASH_XIP(0), CFG_CRC_BENCH_SIZE);
+#endif
+}
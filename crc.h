@@ -0,0 +1,56 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef CRC_H_
+#define CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Checksum service.
+ *
+ * On the device, buffers of at least CFG_CRC_DMA_MIN bytes go through the DMA
+ * sniffer: a dedicated channel reads the data (RAM or flash) into a dummy word
+ * and the sniffer accumulates the CRC at one byte per clock, the CPU only waits.
+ * Shorter buffers, and everything in a host build (!PICO_ON_DEVICE), use the
+ * table-driven software implementation, which gives the same results.
+ *
+ * Both functions are incremental: start with crc = 0 and feed the data in one
+ * or more calls. Main loop only, the sniffer is not shared with interrupts.
+ */
+
+// Claim the DMA channel, the software implementation is used until then
+void crc_init(void);
+
+// CRC-32 (IEEE 802.3, as zlib)
+uint32_t crc32_update(uint32_t crc, void const* data, size_t len);
+
+// CRC-16/XMODEM (CCITT polynomial 0x1021, MSB first, no inversion)
+uint16_t crc16_update(uint16_t crc, void const* data, size_t len);
+
+// Console: crc, throughput of the software and DMA implementations
+void crc_cmd(int argc, char* argv[]);
+
+#endif /* CRC_H_ */
@@ -0,0 +1,419 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "hardware/flash.h"
+#include "hardware/timer.h"
+#include "hardware/watchdog.h"
+#include "pico/time.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "console.h"
+#include "crc.h"
+#include "event_log.h"
+#include "flash_layout.h"
+#include "flash_service.h"
+#include "pool.h"
+#include "usb_stats.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  uint32_t seq;        // record number, never reused; erased: 0xFFFFFFFF
+  uint32_t time_ms;    // since boot
+  uint32_t arg;
+  uint8_t  event;
+  uint8_t  arg8;
+  uint16_t check;      // low half of the CRC-32 of the fields above, written with the record
+} log_record_t;
+
+TU_VERIFY_STATIC(sizeof(log_record_t) == 16, "record layout");
+
+#define LOG_RECORDS          (FLASH_LOG_SIZE / sizeof(log_record_t))
+#define LOG_PAGE_RECORDS     (FLASH_PAGE_SIZE / sizeof(log_record_t))
+#define LOG_SECTOR_RECORDS   (FLASH_SECTOR_SIZE / sizeof(log_record_t))
+#define LOG_PENDING_MAX      (2 * LOG_PAGE_RECORDS)
+
+TU_VERIFY_STATIC(CFG_LOG_SECTORS >= 2, "the ring needs a sector to erase while keeping one");
+
+// Changes with the layout, so a buffer of another firmware is never taken over
+#define LOG_RAM_MAGIC        (0x4C4F0000u | (uint16_t) sizeof(log_ram_t))
+
+// Records not yet in flash
+typedef struct
+{
+  uint32_t magic;
+  uint32_t next_seq;
+  uint32_t count;
+  log_record_t pending[LOG_PENDING_MAX];
+} log_ram_t;
+
+// Survives a watchdog reset: not cleared by the runtime start-up code
+static log_ram_t __uninitialized_ram(log_ram);
+
+static struct
+{
+  uint32_t head;         // index of the next record to write in the ring
+  uint32_t oldest_ms;    // time the oldest pending record was logged
+  uint32_t restored;     // records saved across the last watchdog reset
+  uint32_t dropped;      // records lost because the RAM buffer was full
+  uint32_t pages;
+  uint32_t erases;
+  uint32_t last_task_us;
+  uint32_t max_gap_us;   // longest main loop gap since the last counters record
+  uint32_t counters_ms;
+  uint32_t usb_errors;   // total at the last USB errors record
+  int32_t  dump_pos;     // records left to print by "log dump", -1: idle
+  uint32_t dump_ms;      // time the dump last printed a record
+  uint32_t dump_aborts;  // dumps abandoned, the terminal went away or stopped reading
+  int32_t  erased;       // sector erased ahead of the head, -1: none
+} log_;
+
+static uint8_t page_buf[FLASH_PAGE_SIZE];
+
+static char const* const event_names[LOG_EV_COUNT] =
+{
+  [LOG_EV_BOOT]        = "boot",
+  [LOG_EV_MOUNT]       = "mount",
+  [LOG_EV_UNMOUNT]     = "unmount",
+  [LOG_EV_BUS_RESET]   = "bus-reset",
+  [LOG_EV_SUSPEND]     = "suspend",
+  [LOG_EV_RESUME]      = "resume",
+  [LOG_EV_STALL]       = "stall",
+  [LOG_EV_COUNTERS]    = "counters",
+  [LOG_EV_KV_WRITE]    = "kv-write",
+  [LOG_EV_UPDATE]      = "update",
+  [LOG_EV_USB_ERRORS]  = "usb-errors",
+  [LOG_EV_ERASE_STALL] = "erase-stall",
+};
+
+static uint32_t now_ms(void)
+{
+  return to_ms_since_boot(get_absolute_time());
+}
+
+static uint16_t record_check(log_record_t const* rec)
+{
+  return (uint16_t) crc32_update(0, rec, offsetof(log_record_t, check));
+}
+
+static log_record_t const* ring_record(uint32_t index)
+{
+  return (log_record_t const*) FLASH_XIP(FLASH_LOG_OFFSET) + index;
+}
+
+static bool record_valid(log_record_t const* rec)
+{
+  return rec->seq != 0xFFFFFFFFu && rec->event < LOG_EV_COUNT && rec->check == record_check(rec);
+}
+
+static bool record_blank(log_record_t const* rec)
+{
+  uint32_t const* words = (uint32_t const*) rec;
+  for ( size_t i = 0; i < sizeof(log_record_t) / 4; i++ )
+  {
+    if ( words[i] != 0xFFFFFFFFu ) return false;
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Flash
+//--------------------------------------------------------------------+
+
+// Find the newest record and continue after it
+static uint32_t scan(void)
+{
+  uint32_t next_seq = 1;
+  int32_t newest = -1;
+
+  for ( uint32_t i = 0; i < LOG_RECORDS; i++ )
+  {
+    log_record_t const* rec = ring_record(i);
+    if ( record_valid(rec) && (newest < 0 || rec->seq >= next_seq) )
+    {
+      newest = (int32_t) i;
+      next_seq = rec->seq + 1;
+    }
+  }
+
+  log_.head = (uint32_t) (newest + 1) % LOG_RECORDS;
+
+  // the rest of a page whose programming was interrupted cannot be written again
+  if ( !record_blank(ring_record(log_.head)) && log_.head % LOG_SECTOR_RECORDS )
+  {
+    log_.head = (log_.head + LOG_PAGE_RECORDS) / LOG_PAGE_RECORDS * LOG_PAGE_RECORDS % LOG_RECORDS;
+  }
+
+  return next_seq;
+}
+
+// Sector the head writes next: its own at a sector start, the following one otherwise
+static uint32_t next_sector(void)
+{
+  return (log_.head + LOG_SECTOR_RECORDS - 1) / LOG_SECTOR_RECORDS % CFG_LOG_SECTORS;
+}
+
+// The next flush enters a sector that still holds the oldest records of the ring
+static bool needs_erase(void)
+{
+  return log_.head % LOG_SECTOR_RECORDS == 0 && (int32_t) next_sector() != log_.erased;
+}
+
+static bool sector_blank(uint32_t sector)
+{
+  for ( uint32_t i = 0; i < LOG_SECTOR_RECORDS; i++ )
+  {
+    if ( !record_blank(ring_record(sector * LOG_SECTOR_RECORDS + i)) ) return false;
+  }
+  return true;
+}
+
+static bool erase_sector(uint32_t sector)
+{
+  if ( !flash_service_erase(FLASH_LOG_OFFSET + sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE) ) return false;
+  log_.erases++;
+  return true;
+}
+
+// Write pending records up to the end of the current page, one page program
+static void flush_page(void)
+{
+  if ( log_.head % LOG_SECTOR_RECORDS == 0 )
+  {
+    if ( needs_erase() && !erase_sector(next_sector()) ) return;
+    log_.erased = -1;
+  }
+
+  uint32_t const first = log_.head % LOG_PAGE_RECORDS;
+  uint32_t const n = tu_min32(log_ram.count, LOG_PAGE_RECORDS - first);
+
+  // slots already programmed stay 0xFF in the buffer, programming them again changes nothing
+  memset(page_buf, 0xFF, sizeof(page_buf));
+  for ( uint32_t i = 0; i < n; i++ )
+  {
+    log_record_t rec = log_ram.pending[i];
+    rec.check = record_check(&rec);
+    memcpy(page_buf + (first + i) * sizeof(log_record_t), &rec, sizeof(rec));
+  }
+
+  uint32_t const page = FLASH_LOG_OFFSET + (log_.head - first) * sizeof(log_record_t);
+  if ( !flash_service_program(page, page_buf, FLASH_PAGE_SIZE) ) return;
+  log_.pages++;
+
+  log_ram.count -= n;
+  memmove(log_ram.pending, log_ram.pending + n, log_ram.count * sizeof(log_record_t));
+  log_.head = (log_.head + n) % LOG_RECORDS;
+  log_.oldest_ms = now_ms();
+}
+
+//--------------------------------------------------------------------+
+// Dump
+//--------------------------------------------------------------------+
+
+static void print_record(log_record_t const* rec, char const* where)
+{
+  console_printf("#%-6lu %10lu ms %-9s %3u %10lu%s\r\n", (unsigned long) rec->seq, (unsigned long) rec->time_ms,
+                 event_names[rec->event] ? event_names[rec->event] : "?", rec->arg8, (unsigned long) rec->arg, where);
+}
+
+// Print a few records per call, the CDC FIFO is much smaller than the ring
+static void dump_task(void)
+{
+  // flushing waits for the dump: a terminal that stopped reading must not hold the log up
+  if ( !tud_cdc_connected() || now_ms() - log_.dump_ms > CFG_LOG_DUMP_TIMEOUT_MS )
+  {
+    log_.dump_pos = -1;
+    log_.dump_aborts++;
+    return;
+  }
+
+  // oldest first: start in the sector after the head, end with the pending records
+  uint32_t const start = (log_.head / LOG_SECTOR_RECORDS + 1) % CFG_LOG_SECTORS * LOG_SECTOR_RECORDS;
+  uint32_t const total = LOG_RECORDS - (LOG_SECTOR_RECORDS - log_.head % LOG_SECTOR_RECORDS) + log_ram.count;
+
+  while ( log_.dump_pos >= 0 && tud_cdc_write_available() >= 64 )
+  {
+    uint32_t const pos = (uint32_t) log_.dump_pos;
+
+    if ( pos >= total )
+    {
+      console_printf("end, %lu records pending\r\n", (unsigned long) log_ram.count);
+      log_.dump_pos = -1;
+      break;
+    }
+
+    uint32_t const flashed = total - log_ram.count;
+    if ( pos < flashed )
+    {
+      log_record_t const* rec = ring_record((start + pos) % LOG_RECORDS);
+      if ( record_valid(rec) ) print_record(rec, "");
+    }else
+    {
+      print_record(&log_ram.pending[pos - flashed], " (ram)");
+    }
+
+    log_.dump_pos++;
+    log_.dump_ms = now_ms();
+  }
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void event_log_init(void)
+{
+  uint32_t next_seq = scan();
+
+  // records logged before a watchdog reset but not written yet
+  if ( watchdog_caused_reboot() && log_ram.magic == LOG_RAM_MAGIC && log_ram.count <= LOG_PENDING_MAX &&
+       log_ram.next_seq >= next_seq )
+  {
+    log_.restored = log_ram.count;
+    next_seq = log_ram.next_seq;
+  }else
+  {
+    log_ram.count = 0;
+  }
+
+  log_ram.magic = LOG_RAM_MAGIC;
+  log_ram.next_seq = next_seq;
+  log_.oldest_ms = now_ms();
+  log_.counters_ms = log_.oldest_ms;
+  log_.last_task_us = time_us_32();
+  log_.dump_pos = -1;
+
+  // erased ahead before the reset, or never written
+  log_.erased = sector_blank(next_sector()) ? (int32_t) next_sector() : -1;
+}
+
+void event_log(log_event_t event, uint8_t arg8, uint32_t arg)
+{
+  if ( log_ram.count >= LOG_PENDING_MAX )
+  {
+    log_.dropped++;
+    return;
+  }
+
+  if ( log_ram.count == 0 ) log_.oldest_ms = now_ms();
+
+  log_record_t* rec = &log_ram.pending[log_ram.count];
+  rec->seq = log_ram.next_seq++;
+  rec->time_ms = now_ms();
+  rec->arg = arg;
+  rec->event = (uint8_t) event;
+  rec->arg8 = arg8;
+
+  // count last, a reset in between loses only this record
+  log_ram.count++;
+}
+
+static void sum_failures(pool_t const* pool, void* arg)
+{
+  *(uint32_t*) arg += pool->failed;
+}
+
+void event_log_task(void)
+{
+  uint32_t const now_us = time_us_32();
+  uint32_t const gap_us = now_us - log_.last_task_us;
+
+  if ( gap_us > log_.max_gap_us ) log_.max_gap_us = gap_us;
+  if ( gap_us > CFG_LOG_STALL_MS * 1000u ) event_log(LOG_EV_STALL, 0, gap_us);
+
+  uint32_t const now = now_ms();
+  if ( now - log_.counters_ms >= CFG_LOG_COUNTERS_MS )
+  {
+    uint32_t failed = 0;
+    pool_foreach(sum_failures, &failed);
+
+    event_log(LOG_EV_COUNTERS, (uint8_t) tu_min32(failed, UINT8_MAX), log_.max_gap_us);
+    log_.counters_ms = now;
+    log_.max_gap_us = 0;
+
+    uint32_t const usb_errors = usb_stats_errors();
+    if ( usb_errors != log_.usb_errors )
+    {
+      event_log(LOG_EV_USB_ERRORS, 0, usb_errors);
+      log_.usb_errors = usb_errors;
+    }
+  }
+
+  // Erasing a sector stalls an active bus, so the next one is erased ahead while the
+  // bus is suspended or not configured (it gives up the oldest records a bit early).
+  // A dump in progress walks the ring, keep it still.
+  bool const stalls = flash_service_erase_stalls();
+  if ( !stalls && log_.erased < 0 && log_.dump_pos < 0 && erase_sector(next_sector()) )
+  {
+    log_.erased = (int32_t) next_sector();
+  }
+
+  // batch: write once the current page can be filled, or the records got old.
+  // While suspended the bus does not care, write everything before the power may go.
+  // Age alone does not justify a stalling erase: then hold the records until a page fills.
+  if ( log_ram.count )
+  {
+    uint32_t const room = LOG_PAGE_RECORDS - log_.head % LOG_PAGE_RECORDS;
+    bool const old = now - log_.oldest_ms >= CFG_LOG_FLUSH_MS && !(stalls && needs_erase());
+    bool const due = log_ram.count >= room || old || tud_suspended();
+
+    // a dump in progress walks the ring from the head, keep it still
+    if ( due && log_.dump_pos < 0 )
+    {
+      flush_page();
+    }
+  }
+
+  if ( log_.dump_pos >= 0 ) dump_task();
+
+  // the time spent writing here is not a stall of the main loop
+  log_.last_task_us = time_us_32();
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void event_log_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 && !strcmp(argv[1], "dump") )
+  {
+    log_.dump_pos = 0;
+    log_.dump_ms = now_ms();
+    return;
+  }
+
+  console_printf("next #%lu at %lu/%u, %lu pending, %lu restored after reset, %lu dropped\r\n",
+                 (unsigned long) log_ram.next_seq, (unsigned long) log_.head, (unsigned) LOG_RECORDS,
+                 (unsigned long) log_ram.count, (unsigned long) log_.restored, (unsigned long) log_.dropped);
+  console_printf("%lu pages written, %lu sectors erased, %lu dumps abandoned\r\n", (unsigned long) log_.pages,
+                 (unsigned long) log_.erases, (unsigned long) log_.dump_aborts);
+}
@@ -0,0 +1,82 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef EVENT_LOG_H_
+#define EVENT_LOG_H_
+
+#include <stdint.h>
+
+/* Persistent event log: a ring of 16 byte records in the flash region FLASH_LOG_OFFSET.
+ *
+ * event_log() only stores the record in a RAM buffer. event_log_task() writes the
+ * buffer out one whole page at a time, as soon as it fills the current page or
+ * after CFG_LOG_FLUSH_MS, and erases the oldest sector when the ring wraps. The
+ * RAM buffer is not cleared by the start-up code, so records not yet written
+ * when the watchdog fires are saved after the reset.
+ *
+ * Every CFG_LOG_COUNTERS_MS a counters record is added, followed by a USB
+ * errors record when the controller counted new errors, and a main loop gap
+ * of more than CFG_LOG_STALL_MS is recorded as a stall.
+ *
+ * "log dump" on the console prints the ring, oldest record first.
+ */
+
+typedef enum
+{
+  LOG_EV_BOOT = 1,    // arg8: LOG_BOOT_* flags, arg: warm restarts so far
+  LOG_EV_MOUNT,       // arg8: configuration
+  LOG_EV_UNMOUNT,
+  LOG_EV_BUS_RESET,
+  LOG_EV_SUSPEND,     // arg8: remote wakeup enabled
+  LOG_EV_RESUME,
+  LOG_EV_STALL,       // arg: main loop gap in us
+  LOG_EV_COUNTERS,    // arg8: pool allocations refused (saturated), arg: longest loop gap in us
+  LOG_EV_KV_WRITE,    // arg8: key, arg: 1 if the write failed
+  LOG_EV_UPDATE,      // arg8: 1 committed slot started, 0 boot stage kept the old one; arg: image size
+  LOG_EV_USB_ERRORS,  // arg: USB controller errors since boot (usb_stats.h)
+  LOG_EV_ERASE_STALL, // arg: us a sector erase held off the USB IRQ of an active bus
+  LOG_EV_COUNT
+} log_event_t;
+
+enum
+{
+  LOG_BOOT_WATCHDOG = 0x01, // reset by the watchdog
+  LOG_BOOT_WARM     = 0x02, // state restored from the snapshot
+  LOG_BOOT_GAVE_UP  = 0x04, // valid snapshot discarded after CFG_RECOVERY_MAX_WARM restarts in a row
+};
+
+// Scan the ring and keep records saved across a watchdog reset, call after kv_init()
+void event_log_init(void);
+
+// Record an event, RAM only
+void event_log(log_event_t event, uint8_t arg8, uint32_t arg);
+
+// Write full or old records to flash, add periodic records; call once per main loop iteration
+void event_log_task(void);
+
+// Console: log [dump]
+void event_log_cmd(int argc, char* argv[]);
+
+#endif /* EVENT_LOG_H_ */
@@ -0,0 +1,66 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FLASH_LAYOUT_H_
+#define FLASH_LAYOUT_H_
+
+#include "hardware/flash.h"
+
+#include "app_config.h"
+
+//--------------------------------------------------------------------+
+// Flash regions. The boot stage and the two firmware slots are at the start of
+// flash, the regions used at run time are allocated downwards from the end.
+// Offsets are relative to the start of flash (as for flash_range_program).
+//--------------------------------------------------------------------+
+
+// Boot stage: boot2 and the slot selector (boot/boot_stage.c)
+#define FLASH_BOOT_STAGE_SIZE     CFG_BOOT_STAGE_SIZE
+
+// Firmware slots A (0) and B (1) after it, each image is linked for its slot
+#define FLASH_SLOT_SIZE           CFG_FIRMWARE_SLOT_SIZE
+#define FLASH_SLOT_OFFSET(_slot)  (FLASH_BOOT_STAGE_SIZE + (_slot) * FLASH_SLOT_SIZE)
+
+// Key-value store: the last CFG_KV_SECTORS sectors
+#define FLASH_KV_SIZE       (CFG_KV_SECTORS * FLASH_SECTOR_SIZE)
+#define FLASH_KV_OFFSET     (PICO_FLASH_SIZE_BYTES - FLASH_KV_SIZE)
+
+// Event log ring: CFG_LOG_SECTORS sectors below the key-value store
+#define FLASH_LOG_SIZE      (CFG_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#define FLASH_LOG_OFFSET    (FLASH_KV_OFFSET - FLASH_LOG_SIZE)
+
+// Boot record: the slot the boot stage starts, two sectors below the event log (boot_record.h)
+#define FLASH_BOOT_RECORD_SIZE    (2 * FLASH_SECTOR_SIZE)
+#define FLASH_BOOT_RECORD_OFFSET  (FLASH_LOG_OFFSET - FLASH_BOOT_RECORD_SIZE)
+
+// Lowest region, the slots must end below it
+#define FLASH_DATA_OFFSET   FLASH_BOOT_RECORD_OFFSET
+
+_Static_assert(FLASH_SLOT_OFFSET(2) <= FLASH_DATA_OFFSET, "both firmware slots must fit below the data regions");
+
+// Memory mapped (XIP) address of a flash offset
+#define FLASH_XIP(_offset)  ((uint8_t const*) (uintptr_t) (XIP_BASE + (_offset)))
+
+#endif /* FLASH_LAYOUT_H_ */
@@ -0,0 +1,187 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "hardware/flash.h"
+#include "hardware/structs/usb.h"
+#include "hardware/timer.h"
+#include "pico/flash.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "binlog.h"
+#include "console.h"
+#include "event_log.h"
+#include "flash_service.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  bool erase;
+  uint32_t offset;
+  uint32_t len;
+  uint8_t const* data;
+} flash_op_t;
+
+typedef struct
+{
+  uint32_t erases;
+  uint32_t stalling_erases; // done while the bus was active
+  uint32_t pages;
+  uint32_t failures;        // lockout of core 1 timed out
+  uint32_t max_program_us;  // longest single page, the USB service gap while programming
+  uint32_t max_erase_us;    // longest sector erase, the USB service gap while erasing
+  uint32_t max_frames;      // most USB frames that passed during one operation
+} flash_stats_t;
+
+static flash_stats_t stats;
+
+//--------------------------------------------------------------------+
+// Flash operation, runs with XIP off
+//--------------------------------------------------------------------+
+
+static void __not_in_flash_func(run_op)(void* param)
+{
+  flash_op_t const* op = (flash_op_t const*) param;
+
+  if ( op->erase ) flash_range_erase(op->offset, op->len);
+  else flash_range_program(op->offset, op->data, op->len);
+}
+
+static inline uint32_t frame_number(void)
+{
+  return usb_hw->sof_rd & USB_SOF_RD_BITS;
+}
+
+// Wait for the next start of frame, so the operation has the rest of the frame to itself
+static void sync_to_frame(void)
+{
+  if ( !tud_mounted() || tud_suspended() ) return;
+
+  uint32_t const frame = frame_number();
+  uint32_t const start = time_us_32();
+
+  while ( frame_number() == frame && time_us_32() - start < 1100 ) tight_loop_contents();
+}
+
+static bool execute(flash_op_t* op)
+{
+  bool const stalls = op->erase && flash_service_erase_stalls();
+
+  sync_to_frame();
+
+  uint32_t const frame = frame_number();
+  uint32_t const start = time_us_32();
+
+  int const rc = flash_safe_execute(run_op, op, CFG_FLASH_LOCKOUT_TIMEOUT_MS);
+
+  uint32_t const us = time_us_32() - start;
+  uint32_t const frames = (frame_number() - frame) & USB_SOF_RD_BITS;
+
+  if ( rc != PICO_OK )
+  {
+    stats.failures++;
+    return false;
+  }
+
+  if ( op->erase )
+  {
+    BINLOG("flash erase 0x%06x, %u us, %u frames", op->offset, us, frames);
+    stats.erases++;
+    if ( us > stats.max_erase_us ) stats.max_erase_us = us;
+
+    // the host saw no answer from the device for this long
+    if ( stalls )
+    {
+      stats.stalling_erases++;
+      event_log(LOG_EV_ERASE_STALL, 0, us);
+    }
+  }else
+  {
+    stats.pages++;
+    if ( us > stats.max_program_us ) stats.max_program_us = us;
+  }
+  if ( frames > stats.max_frames ) stats.max_frames = frames;
+
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+bool flash_service_erase_stalls(void)
+{
+  return tud_connected() && !tud_suspended();
+}
+
+bool flash_service_erase(uint32_t offset, uint32_t len)
+{
+  for ( uint32_t done = 0; done < len; done += FLASH_SECTOR_SIZE )
+  {
+    flash_op_t op = { .erase = true, .offset = offset + done, .len = FLASH_SECTOR_SIZE };
+    if ( !execute(&op) ) return false;
+  }
+
+  return true;
+}
+
+bool flash_service_program(uint32_t offset, void const* data, uint32_t len)
+{
+  uint8_t const* src = (uint8_t const*) data;
+
+  // one page per frame
+  for ( uint32_t done = 0; done < len; done += FLASH_PAGE_SIZE )
+  {
+    flash_op_t op = { .erase = false, .offset = offset + done, .len = FLASH_PAGE_SIZE, .data = src + done };
+    if ( !execute(&op) ) return false;
+  }
+
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void flash_service_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 && !strcmp(argv[1], "reset") )
+  {
+    memset(&stats, 0, sizeof(stats));
+    return;
+  }
+
+  console_printf("%lu sector erases (%lu stalled USB), %lu pages programmed, %lu lockout failures\r\n",
+                 (unsigned long) stats.erases, (unsigned long) stats.stalling_erases, (unsigned long) stats.pages,
+                 (unsigned long) stats.failures);
+  console_printf("worst USB service gap: %lu us programming a page, %lu us erasing a sector, %lu frames\r\n",
+                 (unsigned long) stats.max_program_us, (unsigned long) stats.max_erase_us,
+                 (unsigned long) stats.max_frames);
+}
@@ -0,0 +1,59 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FLASH_SERVICE_H_
+#define FLASH_SERVICE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Flash erase/program that keeps USB and core 1 going as far as the hardware allows.
+ *
+ * While flash is being written XIP is unavailable, so the operation runs from RAM
+ * through flash_safe_execute(): interrupts are off on this core and core 1 is
+ * parked in RAM by the multicore lockout. Programs are split into single pages,
+ * each started right after a USB start of frame so that it completes within the
+ * frame; interrupts (and so the USB IRQ) run between pages. A sector erase cannot
+ * be split: it holds the USB IRQ off for its whole duration (45 ms typical, up to
+ * 400 ms), so on a configured, active bus every erase stalls USB. Callers erase
+ * ahead of time while flash_service_erase_stalls() is false; an erase that does
+ * stall the bus is counted and logged as LOG_EV_ERASE_STALL.
+ *
+ * The longest time the USB IRQ was held off is recorded as the service gap.
+ */
+
+// True while an erase would stall USB: the host talks to the device and it is not suspended
+bool flash_service_erase_stalls(void);
+
+// Erase whole sectors, offset and len sector aligned
+bool flash_service_erase(uint32_t offset, uint32_t len);
+
+// Program whole pages, offset and len page aligned, data must not be in flash
+bool flash_service_program(uint32_t offset, void const* data, uint32_t len);
+
+// Console: flash [reset]
+void flash_service_cmd(int argc, char* argv[]);
+
+#endif /* FLASH_SERVICE_H_ */
@@ -0,0 +1,372 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef HID_REPORT_DESC_HPP_
+#define HID_REPORT_DESC_HPP_
+
+/* Compile-time HID report layouts.
+ *
+ * A report is declared once as a list of fields bound to the members of a plain
+ * C struct. From that single declaration we derive
+ *  - the report descriptor bytes (constexpr, HID 1.11 short items), and
+ *  - pack(), which writes the struct into the wire format at bit offsets fixed
+ *    at compile time, without any data dependent branch.
+ *
+ *   using mouse = hid::input_report<mouse_report_t, REPORT_ID_MOUSE,
+ *                   hid::page::desktop, hid::desktop::mouse,
+ *                   hid::field<&mouse_report_t::buttons, hid::buttons<5>>,
+ *                   hid::padding<3>,
+ *                   hid::field<&mouse_report_t::x, hid::relative<hid::page::desktop, hid::desktop::x, 8>>>;
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+namespace hid {
+
+//--------------------------------------------------------------------+
+// Usage tables (only what our reports use)
+//--------------------------------------------------------------------+
+
+namespace page {
+  constexpr uint16_t desktop  = 0x01;
+  constexpr uint16_t button   = 0x09;
+  constexpr uint16_t consumer = 0x0C;
+  constexpr uint16_t vendor   = 0xFF00;
+}
+
+namespace desktop {
+  constexpr uint16_t pointer = 0x01;
+  constexpr uint16_t mouse   = 0x02;
+  constexpr uint16_t x       = 0x30;
+  constexpr uint16_t y       = 0x31;
+  constexpr uint16_t wheel   = 0x38;
+}
+
+namespace consumer {
+  constexpr uint16_t ac_pan = 0x0238;
+}
+
+namespace vendor {
+  constexpr uint16_t sequence = 0x01;  // report sequence number, ignored by the host's mouse driver
+}
+
+//--------------------------------------------------------------------+
+// Constexpr byte sequences
+//--------------------------------------------------------------------+
+
+template <std::size_t N>
+struct bytes
+{
+  uint8_t data[N];
+  static constexpr std::size_t size = N;
+};
+
+// zero length sequence, so that an empty item list still concatenates
+template <>
+struct bytes<0>
+{
+  static constexpr std::size_t size = 0;
+};
+
+template <std::size_t A, std::size_t B>
+constexpr bytes<A + B> operator+(bytes<A> const& a, bytes<B> const& b)
+{
+  bytes<A + B> r{};
+  if constexpr ( A > 0 ) for ( std::size_t i = 0; i < A; i++ ) r.data[i] = a.data[i];
+  if constexpr ( B > 0 ) for ( std::size_t i = 0; i < B; i++ ) r.data[A + i] = b.data[i];
+  return r;
+}
+
+//--------------------------------------------------------------------+
+// Short items
+//--------------------------------------------------------------------+
+
+namespace item {
+  // prefix with bSize = 0, see HID 1.11 section 6.2.2.2
+  constexpr uint8_t input          = 0x80;
+  constexpr uint8_t collection     = 0xA0;
+  constexpr uint8_t end_collection = 0xC0;
+  constexpr uint8_t usage_page     = 0x04;
+  constexpr uint8_t logical_min    = 0x14;
+  constexpr uint8_t logical_max    = 0x24;
+  constexpr uint8_t report_size    = 0x74;
+  constexpr uint8_t report_id      = 0x84;
+  constexpr uint8_t report_count   = 0x94;
+  constexpr uint8_t usage          = 0x08;
+  constexpr uint8_t usage_min      = 0x18;
+  constexpr uint8_t usage_max      = 0x28;
+}
+
+namespace flags {
+  constexpr uint8_t constant = 0x01;
+  constexpr uint8_t variable = 0x02;
+  constexpr uint8_t relative = 0x04;
+}
+
+namespace collection {
+  constexpr uint8_t physical    = 0x00;
+  constexpr uint8_t application = 0x01;
+}
+
+constexpr std::size_t unsigned_len(uint32_t v) { return v <= 0xFF ? 1 : v <= 0xFFFF ? 2 : 4; }
+constexpr std::size_t signed_len(int32_t v)    { return (v >= -128 && v <= 127) ? 1 : (v >= -32768 && v <= 32767) ? 2 : 4; }
+
+template <uint8_t Prefix, std::size_t Len>
+constexpr bytes<1 + Len> short_item(uint32_t value)
+{
+  bytes<1 + Len> r{};
+  r.data[0] = (uint8_t) (Prefix | (Len == 4 ? 3 : Len));
+  for ( std::size_t i = 0; i < Len; i++ ) r.data[1 + i] = (uint8_t) (value >> (8 * i));
+  return r;
+}
+
+template <uint8_t Prefix, uint32_t V>
+constexpr auto uitem() { return short_item<Prefix, unsigned_len(V)>(V); }
+
+template <uint8_t Prefix, int32_t V>
+constexpr auto sitem() { return short_item<Prefix, signed_len(V)>((uint32_t) V); }
+
+// Usage Page only when it differs from the one already in effect
+template <uint16_t Prev, uint16_t Page>
+constexpr auto usage_page()
+{
+  if constexpr ( Page == 0 || Page == Prev ) return bytes<0>{};
+  else return uitem<item::usage_page, Page>();
+}
+
+//--------------------------------------------------------------------+
+// Bit packing
+//--------------------------------------------------------------------+
+
+// OR the low Bits of value into out[] at bit Offset (LSB first, as HID requires).
+// Offset and Bits are constants so the loop fully unrolls into shifts and stores.
+template <unsigned Offset, unsigned Bits>
+inline void put_bits(uint8_t* out, uint32_t value)
+{
+  static_assert(Bits > 0 && Bits <= 32, "field width must be 1..32 bits");
+
+  uint64_t const v = (uint64_t) (value & (Bits == 32 ? 0xFFFFFFFFu : ((1u << Bits) - 1))) << (Offset % 8);
+  constexpr unsigned first = Offset / 8;
+  constexpr unsigned count = (Offset % 8 + Bits + 7) / 8;
+
+  for ( unsigned i = 0; i < count; i++ ) out[first + i] |= (uint8_t) (v >> (8 * i));
+}
+
+//--------------------------------------------------------------------+
+// Field specifications
+//--------------------------------------------------------------------+
+
+// N one-bit buttons, usages 1..N of the Button page
+template <unsigned N>
+struct buttons
+{
+  static constexpr uint16_t page = page::button;
+  static constexpr unsigned bits = N;
+
+  static constexpr auto descriptor()
+  {
+    return uitem<item::usage_min, 1>() + uitem<item::usage_max, N>() +
+           sitem<item::logical_min, 0>() + sitem<item::logical_max, 1>() +
+           uitem<item::report_count, N>() + uitem<item::report_size, 1>() +
+           uitem<item::input, flags::variable>();
+  }
+};
+
+// Single variable value with a logical range, e.g an axis or wheel
+template <uint16_t Page, uint16_t Usage, unsigned Bits, int32_t Min, int32_t Max, uint8_t Flags>
+struct value
+{
+  static_assert(Min <= Max, "logical minimum must not exceed maximum");
+  static_assert(Min >= 0 ? (Bits == 32 || (uint32_t) Max < (1ull << Bits))
+                         : (Bits == 32 || ((int64_t) Min >= -(1ll << (Bits - 1)) && (int64_t) Max < (1ll << (Bits - 1)))),
+                "logical range does not fit the field width");
+
+  static constexpr uint16_t page = Page;
+  static constexpr unsigned bits = Bits;
+
+  static constexpr auto descriptor()
+  {
+    return uitem<item::usage, Usage>() +
+           sitem<item::logical_min, Min>() + sitem<item::logical_max, Max>() +
+           uitem<item::report_count, 1>() + uitem<item::report_size, Bits>() +
+           uitem<item::input, (uint8_t) (flags::variable | Flags)>();
+  }
+};
+
+// Relative signed value using the whole symmetric range, the usual mouse delta
+template <uint16_t Page, uint16_t Usage, unsigned Bits>
+using relative = value<Page, Usage, Bits, -(int32_t) ((1ull << (Bits - 1)) - 1), (int32_t) ((1ull << (Bits - 1)) - 1), flags::relative>;
+
+// Absolute unsigned value covering the whole field, e.g a vendor counter
+template <uint16_t Page, uint16_t Usage, unsigned Bits>
+using absolute = value<Page, Usage, Bits, 0, (int32_t) ((1ull << Bits) - 1), 0>;
+
+//--------------------------------------------------------------------+
+// Report items: fields bound to struct members, padding, collections
+//--------------------------------------------------------------------+
+
+template <auto Member, typename Spec>
+struct field
+{
+  static constexpr uint16_t page = Spec::page;
+  static constexpr unsigned bits = Spec::bits;
+
+  template <uint16_t Prev>
+  static constexpr auto descriptor() { return usage_page<Prev, Spec::page>() + Spec::descriptor(); }
+
+  template <uint16_t Prev>
+  static constexpr uint16_t page_after() { return Spec::page; }
+
+  template <unsigned Offset, typename S>
+  static void store(uint8_t* out, S const& s) { put_bits<Offset, Spec::bits>(out, (uint32_t) (s.*Member)); }
+};
+
+template <unsigned Bits>
+struct padding
+{
+  static constexpr unsigned bits = Bits;
+
+  template <uint16_t Prev>
+  static constexpr auto descriptor()
+  {
+    return uitem<item::report_count, 1>() + uitem<item::report_size, Bits>() + uitem<item::input, flags::constant>();
+  }
+
+  template <uint16_t Prev>
+  static constexpr uint16_t page_after() { return Prev; }
+
+  template <unsigned Offset, typename S>
+  static void store(uint8_t*, S const&) { }
+};
+
+namespace detail {
+
+  // Concatenate item descriptors, threading the Usage Page in effect through the list
+  template <uint16_t Prev>
+  constexpr auto items_descriptor() { return bytes<0>{}; }
+
+  template <uint16_t Prev, typename First, typename... Rest>
+  constexpr auto items_descriptor()
+  {
+    return First::template descriptor<Prev>() + items_descriptor<First::template page_after<Prev>(), Rest...>();
+  }
+
+  template <uint16_t Prev>
+  constexpr uint16_t items_page_after() { return Prev; }
+
+  template <uint16_t Prev, typename First, typename... Rest>
+  constexpr uint16_t items_page_after() { return items_page_after<First::template page_after<Prev>(), Rest...>(); }
+
+  // Bit offset of item I within the list
+  template <typename... Items>
+  constexpr unsigned offset_of(std::size_t index)
+  {
+    unsigned const widths[] = { Items::bits..., 0 };
+    unsigned offset = 0;
+    for ( std::size_t i = 0; i < index; i++ ) offset += widths[i];
+    return offset;
+  }
+
+  template <unsigned Base, typename S, typename... Items, std::size_t... I>
+  inline void store_items(uint8_t* out, S const& s, std::index_sequence<I...>)
+  {
+    (std::tuple_element_t<I, std::tuple<Items...>>::template store<Base + offset_of<Items...>(I)>(out, s), ...);
+  }
+
+} // namespace detail
+
+// Physical collection grouping several items under one usage, e.g Pointer
+template <uint16_t Page, uint16_t Usage, typename... Items>
+struct physical
+{
+  static constexpr unsigned bits = (0 + ... + Items::bits);
+
+  template <uint16_t Prev>
+  static constexpr auto descriptor()
+  {
+    return usage_page<Prev, Page>() + uitem<item::usage, Usage>() +
+           uitem<item::collection, collection::physical>() +
+           detail::items_descriptor<(Page ? Page : Prev), Items...>() +
+           bytes<1>{ { item::end_collection } };
+  }
+
+  template <uint16_t Prev>
+  static constexpr uint16_t page_after() { return detail::items_page_after<(Page ? Page : Prev), Items...>(); }
+
+  template <unsigned Offset, typename S>
+  static void store(uint8_t* out, S const& s)
+  {
+    detail::store_items<Offset, S, Items...>(out, s, std::index_sequence_for<Items...>{});
+  }
+};
+
+//--------------------------------------------------------------------+
+// Input report: one Application collection with its own Report ID
+//--------------------------------------------------------------------+
+
+template <typename S, uint8_t Id, uint16_t Page, uint16_t Usage, typename... Items>
+struct input_report
+{
+  using struct_type = S;
+
+  static constexpr uint8_t  id   = Id;
+  static constexpr unsigned bits = (0 + ... + Items::bits);
+  static constexpr std::size_t size = bits / 8; // payload, without the report ID
+
+  static_assert(Id != 0, "report ID 0 is reserved");
+  static_assert(bits % 8 == 0, "report must be a whole number of bytes, add padding<>");
+
+  static constexpr auto descriptor()
+  {
+    return uitem<item::usage_page, Page>() + uitem<item::usage, Usage>() +
+           uitem<item::collection, collection::application>() +
+           uitem<item::report_id, Id>() +
+           detail::items_descriptor<Page, Items...>() +
+           bytes<1>{ { item::end_collection } };
+  }
+
+  // Serialize s into out[0..size), returns size
+  static std::size_t pack(uint8_t* out, S const& s)
+  {
+    std::memset(out, 0, size);
+    detail::store_items<0, S, Items...>(out, s, std::index_sequence_for<Items...>{});
+    return size;
+  }
+};
+
+// Report descriptor holding all the given reports, in order
+template <typename... Reports>
+constexpr auto report_descriptor()
+{
+  return (bytes<0>{} + ... + Reports::descriptor());
+}
+
+} // namespace hid
+
+#endif /* HID_REPORT_DESC_HPP_ */
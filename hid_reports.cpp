@@ -0,0 +1,102 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "tusb.h"
+#include "app_config.h"
+
+#include "hid_report_desc.hpp"
+#include "hid_reports.h"
+
+//--------------------------------------------------------------------+
+// Report layouts
+//--------------------------------------------------------------------+
+
+namespace {
+
+using mouse_layout = hid::input_report<mouse_report_t, REPORT_ID_MOUSE, hid::page::desktop, hid::desktop::mouse,
+  hid::physical<hid::page::desktop, hid::desktop::pointer,
+    hid::field<&mouse_report_t::buttons, hid::buttons<5>>,
+    hid::padding<3>,
+    hid::field<&mouse_report_t::x,       hid::relative<hid::page::desktop,  hid::desktop::x,        8>>,
+    hid::field<&mouse_report_t::y,       hid::relative<hid::page::desktop,  hid::desktop::y,        8>>,
+    hid::field<&mouse_report_t::wheel,   hid::relative<hid::page::desktop,  hid::desktop::wheel,    8>>,
+    hid::field<&mouse_report_t::pan,     hid::relative<hid::page::consumer, hid::consumer::ac_pan,  8>>
+  >,
+  hid::field<&mouse_report_t::seq,       hid::absolute<hid::page::vendor,   hid::vendor::sequence,  16>>
+>;
+
+using hires_mouse_layout = hid::input_report<hires_mouse_report_t, REPORT_ID_HIRES_MOUSE, hid::page::desktop, hid::desktop::mouse,
+  hid::physical<hid::page::desktop, hid::desktop::pointer,
+    hid::field<&hires_mouse_report_t::buttons, hid::buttons<5>>,
+    hid::padding<3>,
+    hid::field<&hires_mouse_report_t::x,     hid::relative<hid::page::desktop,  hid::desktop::x,        16>>,
+    hid::field<&hires_mouse_report_t::y,     hid::relative<hid::page::desktop,  hid::desktop::y,        16>>,
+    hid::field<&hires_mouse_report_t::wheel, hid::relative<hid::page::desktop,  hid::desktop::wheel,    8>>,
+    hid::field<&hires_mouse_report_t::pan,   hid::relative<hid::page::consumer, hid::consumer::ac_pan,  8>>
+  >,
+  hid::field<&hires_mouse_report_t::seq,     hid::absolute<hid::page::vendor,   hid::vendor::sequence,  16>>
+>;
+
+constexpr auto report_desc       = hid::report_descriptor<mouse_layout>();
+constexpr auto report_desc_hires = hid::report_descriptor<hires_mouse_layout>();
+
+static_assert(report_desc.size == DESC_HID_REPORT_LEN, "update DESC_HID_REPORT_LEN in hid_reports.h");
+static_assert(report_desc_hires.size == DESC_HID_REPORT_HIRES_LEN, "update DESC_HID_REPORT_HIRES_LEN in hid_reports.h");
+static_assert(mouse_layout::size + 1 <= CFG_TUD_HID_EP_BUFSIZE, "mouse report does not fit CFG_TUD_HID_EP_BUFSIZE");
+static_assert(hires_mouse_layout::size + 1 <= CFG_TUD_HID_EP_BUFSIZE, "hires mouse report does not fit CFG_TUD_HID_EP_BUFSIZE");
+
+template <typename T, std::size_t N>
+constexpr T to_c(hid::bytes<N> const& b)
+{
+  static_assert(sizeof(T::bytes) == N, "descriptor length mismatch");
+
+  T r{};
+  for ( std::size_t i = 0; i < N; i++ ) r.bytes[i] = b.data[i];
+  return r;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------+
+// HID Report Descriptor
+//--------------------------------------------------------------------+
+
+// constant-initialised, so it lands in flash and desc_check can read it from the ELF
+desc_hid_report_t const desc_hid_report = to_c<desc_hid_report_t>(report_desc);
+desc_hid_report_hires_t const desc_hid_report_hires = to_c<desc_hid_report_hires_t>(report_desc_hires);
+
+//--------------------------------------------------------------------+
+// Packers
+//--------------------------------------------------------------------+
+
+uint16_t __hot_path_func(hid_pack_mouse)(uint8_t* buf, mouse_report_t const* report)
+{
+  return (uint16_t) mouse_layout::pack(buf, *report);
+}
+
+uint16_t __hot_path_func(hid_pack_hires_mouse)(uint8_t* buf, hires_mouse_report_t const* report)
+{
+  return (uint16_t) hires_mouse_layout::pack(buf, *report);
+}
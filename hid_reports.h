@@ -0,0 +1,101 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef HID_REPORTS_H_
+#define HID_REPORTS_H_
+
+#include <stdint.h>
+
+#include "usb_descriptors.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+//--------------------------------------------------------------------+
+// Report values
+//--------------------------------------------------------------------+
+
+// The wire layout of each report is declared once in hid_reports.cpp, bound to
+// the members of these structs. The descriptor and the packers come from there.
+
+// REPORT_ID_MOUSE
+typedef struct
+{
+  uint8_t buttons; // bit 0..4: left, right, middle, backward, forward
+  int8_t  x;
+  int8_t  y;
+  int8_t  wheel;
+  int8_t  pan;
+  uint16_t seq;    // vendor defined, numbers the reports in stress mode (stress.h), 0 otherwise
+} mouse_report_t;
+
+// REPORT_ID_HIRES_MOUSE, on the high-rate interface
+typedef struct
+{
+  uint8_t buttons;
+  int16_t x;
+  int16_t y;
+  int8_t  wheel;
+  int8_t  pan;
+  uint16_t seq;
+} hires_mouse_report_t;
+
+//--------------------------------------------------------------------+
+// Report descriptors
+//--------------------------------------------------------------------+
+
+// Lengths are needed by the configuration descriptors in C.
+// hid_reports.cpp fails to compile if they get out of date.
+#define DESC_HID_REPORT_LEN         107
+#define DESC_HID_REPORT_HIRES_LEN   111
+
+// Wrapped in structs so the C++ side can constant-initialise them from the generated bytes
+typedef struct
+{
+  uint8_t bytes[DESC_HID_REPORT_LEN];
+} desc_hid_report_t;
+
+typedef struct
+{
+  uint8_t bytes[DESC_HID_REPORT_HIRES_LEN];
+} desc_hid_report_hires_t;
+
+extern desc_hid_report_t const desc_hid_report;             // HID_INSTANCE_MOUSE
+extern desc_hid_report_hires_t const desc_hid_report_hires; // HID_INSTANCE_HIRES
+
+//--------------------------------------------------------------------+
+// Packers
+//--------------------------------------------------------------------+
+
+// Serialize report into buf, return payload length (without report ID) for tud_hid_report()
+uint16_t hid_pack_mouse(uint8_t* buf, mouse_report_t const* report);
+uint16_t hid_pack_hires_mouse(uint8_t* buf, hires_mouse_report_t const* report);
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif /* HID_REPORTS_H_ */
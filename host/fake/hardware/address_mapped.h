@@ -0,0 +1,40 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_HARDWARE_ADDRESS_MAPPED_H_
+#define FAKE_HARDWARE_ADDRESS_MAPPED_H_
+
+#include <stdint.h>
+
+// Flash is a RAM array, its XIP aliases all point at it
+extern uint8_t fake_flash[];
+
+#define XIP_BASE                  ((uintptr_t) fake_flash)
+#define XIP_NOCACHE_NOALLOC_BASE  XIP_BASE
+
+static inline void hw_set_bits(volatile uint32_t* addr, uint32_t mask) { *addr |= mask; }
+static inline void hw_clear_bits(volatile uint32_t* addr, uint32_t mask) { *addr &= ~mask; }
+
+#endif /* FAKE_HARDWARE_ADDRESS_MAPPED_H_ */
@@ -0,0 +1,73 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_HARDWARE_CLOCKS_H_
+#define FAKE_HARDWARE_CLOCKS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+  volatile uint32_t ctrl;
+  volatile uint32_t div;
+  volatile uint32_t selected;
+} clock_hw_t;
+
+typedef struct
+{
+  clock_hw_t clk[10];
+  volatile uint32_t wake_en0;
+  volatile uint32_t wake_en1;
+  volatile uint32_t sleep_en0;
+  volatile uint32_t sleep_en1;
+  volatile uint32_t enabled0;
+  volatile uint32_t enabled1;
+  volatile uint32_t intr;
+  volatile uint32_t inte;
+  volatile uint32_t intf;
+  volatile uint32_t ints;
+} clocks_hw_t;
+
+extern clocks_hw_t* clocks_hw;
+
+enum clock_index
+{
+  clk_gpout0 = 0, clk_gpout1, clk_gpout2, clk_gpout3, clk_ref, clk_sys, clk_peri, clk_usb, clk_adc, clk_rtc, CLK_COUNT
+};
+
+#define CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS               0x00040000u
+#define CLOCKS_SLEEP_EN1_CLK_SYS_USBCTRL_BITS             0x01000000u
+#define CLOCKS_SLEEP_EN1_CLK_USB_USBCTRL_BITS             0x02000000u
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX  0x1u
+#define CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS   0x0u
+#define CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB   0x1u
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS  0x1u
+
+// Only records the frequency, the simulation runs at the same speed at any clock
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq);
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif /* FAKE_HARDWARE_CLOCKS_H_ */
@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_HARDWARE_DMA_H_
+#define FAKE_HARDWARE_DMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pico.h"
+
+typedef struct
+{
+  uint32_t ctrl;
+} dma_channel_config;
+
+enum dma_channel_transfer_size
+{
+  DMA_SIZE_8 = 0,
+  DMA_SIZE_16 = 1,
+  DMA_SIZE_32 = 2
+};
+
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC32   0x0u
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC32R  0x1u
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC16   0x2u
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC16R  0x3u
+
+// Transfers complete within dma_channel_configure(), channels are never busy
+int dma_claim_unused_channel(bool required);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_wait_for_finish_blocking(uint channel);
+
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config* c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config* c, bool incr);
+void channel_config_set_write_increment(dma_channel_config* c, bool incr);
+void channel_config_set_dreq(dma_channel_config* c, uint dreq);
+void channel_config_set_sniff_enable(dma_channel_config* c, bool sniff_enable);
+void dma_channel_configure(uint channel, dma_channel_config const* config, volatile void* write_addr,
+                           volatile void const* read_addr, uint transfer_count, bool trigger);
+
+#endif /* FAKE_HARDWARE_DMA_H_ */
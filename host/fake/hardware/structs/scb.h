@@ -0,0 +1,46 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_HARDWARE_STRUCTS_SCB_H_
+#define FAKE_HARDWARE_STRUCTS_SCB_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+  volatile uint32_t cpuid;
+  volatile uint32_t icsr;
+  volatile uint32_t vtor;
+  volatile uint32_t aircr;
+  volatile uint32_t scr;
+} armv6m_scb_hw_t;
+
+extern armv6m_scb_hw_t* scb_hw;
+
+#define M0PLUS_SCR_SLEEPDEEP_BITS       0x00000004u
+#define M0PLUS_AIRCR_VECTKEY_LSB        16u
+#define M0PLUS_AIRCR_SYSRESETREQ_BITS   0x00000004u
+
+#endif /* FAKE_HARDWARE_STRUCTS_SCB_H_ */
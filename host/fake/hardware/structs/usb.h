@@ -0,0 +1,90 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_HARDWARE_STRUCTS_USB_H_
+#define FAKE_HARDWARE_STRUCTS_USB_H_
+
+#include <stdint.h>
+
+// Only SOF_RD is alive: it follows the frames of the simulated bus (fake_tusb.c)
+typedef struct
+{
+  volatile uint32_t dev_addr_ctrl;
+  volatile uint32_t int_ep_ctrl[15];
+  volatile uint32_t buf_status;
+  volatile uint32_t buf_cpu_should_handle;
+  volatile uint32_t abort;
+  volatile uint32_t abort_done;
+  volatile uint32_t ep_stall_arm;
+  volatile uint32_t nak_poll;
+  volatile uint32_t ep_nak_stall_status;
+  volatile uint32_t muxing;
+  volatile uint32_t pwr;
+  volatile uint32_t phy_direct;
+  volatile uint32_t phy_direct_override;
+  volatile uint32_t phy_trim;
+  volatile uint32_t linestate_tuning;
+  volatile uint32_t intr;
+  volatile uint32_t inte;
+  volatile uint32_t intf;
+  volatile uint32_t ints;
+  volatile uint32_t sof_wr;
+  volatile uint32_t sof_rd;
+  volatile uint32_t sie_ctrl;
+  volatile uint32_t sie_status;
+} usb_hw_t;
+
+extern usb_hw_t* usb_hw;
+
+#define USB_NUM_ENDPOINTS 16
+
+typedef struct
+{
+  volatile uint8_t setup_packet[8];
+  struct
+  {
+    volatile uint32_t in;
+    volatile uint32_t out;
+  } ep_ctrl[USB_NUM_ENDPOINTS - 1];
+  struct
+  {
+    volatile uint32_t in;
+    volatile uint32_t out;
+  } ep_buf_ctrl[USB_NUM_ENDPOINTS];
+} usb_device_dpram_t;
+
+extern usb_device_dpram_t* usb_dpram;
+
+#define USB_SOF_RD_BITS                       0x000007ffu
+#define USB_SIE_CTRL_EP0_INT_NAK_BITS         0x08000000u
+#define USB_SIE_STATUS_DATA_SEQ_ERROR_BITS    0x80000000u
+#define USB_SIE_STATUS_RX_TIMEOUT_BITS        0x08000000u
+#define USB_SIE_STATUS_RX_OVERFLOW_BITS       0x04000000u
+#define USB_SIE_STATUS_BIT_STUFF_ERROR_BITS   0x02000000u
+#define USB_SIE_STATUS_CRC_ERROR_BITS         0x01000000u
+#define EP_CTRL_ENABLE_BITS                   0x80000000u
+#define EP_CTRL_INTERRUPT_ON_NAK              0x00010000u
+
+#endif /* FAKE_HARDWARE_STRUCTS_USB_H_ */
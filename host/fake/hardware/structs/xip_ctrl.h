@@ -0,0 +1,45 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_HARDWARE_STRUCTS_XIP_CTRL_H_
+#define FAKE_HARDWARE_STRUCTS_XIP_CTRL_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+  volatile uint32_t ctrl;
+  volatile uint32_t flush;
+  volatile uint32_t stat;
+  volatile uint32_t ctr_hit;
+  volatile uint32_t ctr_acc;
+  volatile uint32_t stream_addr;
+  volatile uint32_t stream_ctr;
+  volatile uint32_t stream_fifo;
+} xip_ctrl_hw_t;
+
+extern xip_ctrl_hw_t* xip_ctrl_hw;
+
+#endif /* FAKE_HARDWARE_STRUCTS_XIP_CTRL_H_ */
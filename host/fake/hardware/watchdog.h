@@ -0,0 +1,54 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_HARDWARE_WATCHDOG_H_
+#define FAKE_HARDWARE_WATCHDOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+  volatile uint32_t ctrl;
+  volatile uint32_t load;
+  volatile uint32_t reason;
+  volatile uint32_t scratch[8];
+  volatile uint32_t tick;
+} watchdog_hw_t;
+
+extern watchdog_hw_t* watchdog_hw;
+
+// The simulation always starts from a cold boot
+bool watchdog_caused_reboot(void);
+bool watchdog_enable_caused_reboot(void);
+
+// Enabled, the time between updates is checked against the delay (sim.h)
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
+void watchdog_update(void);
+
+// Recorded as a reboot request, the firmware keeps running
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms);
+
+#endif /* FAKE_HARDWARE_WATCHDOG_H_ */
@@ -0,0 +1,47 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_PICO_H_
+#define FAKE_PICO_H_
+
+// Host build of the firmware (host/): code and data placement has no meaning here
+
+#ifndef PICO_ON_DEVICE
+#define PICO_ON_DEVICE 0
+#endif
+
+#define __not_in_flash_func(_name)              _name
+#define __no_inline_not_in_flash_func(_name)    __attribute__((noinline)) _name
+#define __scratch_x(_group)
+#define __scratch_y(_group)
+
+// plain RAM: the soak harness never simulates a warm reset
+#define __uninitialized_ram(_name)              _name
+
+typedef unsigned int uint;
+
+static inline void tight_loop_contents(void) { }
+
+#endif /* FAKE_PICO_H_ */
@@ -0,0 +1,284 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef FAKE_TUSB_H_
+#define FAKE_TUSB_H_
+
+/* The part of the TinyUSB device API the firmware uses, implemented by
+ * host/fake_tusb.c on a simulated bus. Descriptor macros and types follow
+ * TinyUSB 0.17, so usb_descriptors.c builds unchanged.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "tusb_config.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+//--------------------------------------------------------------------+
+// Common
+//--------------------------------------------------------------------+
+
+#ifdef __cplusplus
+  #define TU_VERIFY_STATIC  static_assert
+#else
+  #define TU_VERIFY_STATIC  _Static_assert
+#endif
+
+#define TU_ATTR_WEAK          __attribute__ ((weak))
+#define TU_ARRAY_SIZE(_arr)   ( sizeof(_arr) / sizeof(_arr[0]) )
+#define TU_U16_HIGH(_u16)     ((uint8_t) (((_u16) >> 8) & 0x00ff))
+#define TU_U16_LOW(_u16)      ((uint8_t) ((_u16)       & 0x00ff))
+#define U16_TO_U8S_LE(_u16)   TU_U16_LOW(_u16), TU_U16_HIGH(_u16)
+
+#define TUD_OPT_HIGH_SPEED    0
+
+static inline uint32_t tu_min32(uint32_t x, uint32_t y) { return (x < y) ? x : y; }
+static inline uint32_t tu_max32(uint32_t x, uint32_t y) { return (x > y) ? x : y; }
+
+static inline uint16_t tu_unaligned_read16(void const* mem)
+{
+  uint16_t v;
+  memcpy(&v, mem, sizeof(v));
+  return v;
+}
+
+#define tu_le16toh(_x)  (_x)
+
+//--------------------------------------------------------------------+
+// Descriptors
+//--------------------------------------------------------------------+
+
+enum
+{
+  TUSB_DESC_DEVICE = 0x01,
+  TUSB_DESC_CONFIGURATION = 0x02,
+  TUSB_DESC_STRING = 0x03,
+  TUSB_DESC_INTERFACE = 0x04,
+  TUSB_DESC_ENDPOINT = 0x05,
+  TUSB_DESC_DEVICE_QUALIFIER = 0x06,
+  TUSB_DESC_OTHER_SPEED_CONFIG = 0x07,
+  TUSB_DESC_INTERFACE_ASSOCIATION = 0x0B,
+  TUSB_DESC_CS_INTERFACE = 0x24,
+};
+
+enum
+{
+  TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP = 1u << 5,
+  TUSB_DESC_CONFIG_ATT_SELF_POWERED  = 1u << 6,
+};
+
+enum
+{
+  TUSB_CLASS_CDC = 2,
+  TUSB_CLASS_HID = 3,
+  TUSB_CLASS_CDC_DATA = 10,
+};
+
+typedef struct __attribute__ ((packed))
+{
+  uint8_t  bLength;
+  uint8_t  bDescriptorType;
+  uint16_t bcdUSB;
+  uint8_t  bDeviceClass;
+  uint8_t  bDeviceSubClass;
+  uint8_t  bDeviceProtocol;
+  uint8_t  bMaxPacketSize0;
+  uint16_t idVendor;
+  uint16_t idProduct;
+  uint16_t bcdDevice;
+  uint8_t  iManufacturer;
+  uint8_t  iProduct;
+  uint8_t  iSerialNumber;
+  uint8_t  bNumConfigurations;
+} tusb_desc_device_t;
+
+typedef struct __attribute__ ((packed))
+{
+  uint8_t  bLength;
+  uint8_t  bDescriptorType;
+  uint16_t bcdUSB;
+  uint8_t  bDeviceClass;
+  uint8_t  bDeviceSubClass;
+  uint8_t  bDeviceProtocol;
+  uint8_t  bMaxPacketSize0;
+  uint8_t  bNumConfigurations;
+  uint8_t  bReserved;
+} tusb_desc_device_qualifier_t;
+
+#define TUD_CONFIG_DESC_LEN   (9)
+
+#define TUD_CONFIG_DESCRIPTOR(config_num, _itfcount, _stridx, _total_len, _attribute, _power_ma) \
+  9, TUSB_DESC_CONFIGURATION, U16_TO_U8S_LE(_total_len), _itfcount, config_num, _stridx, TU_BIT(7) | _attribute, (_power_ma)/2
+
+#define TU_BIT(_n)            (1UL << (_n))
+
+#define TUD_CDC_DESC_LEN      (8+9+5+5+4+5+7+9+7+7)
+
+#define TUD_CDC_DESCRIPTOR(_itfnum, _stridx, _ep_notif, _ep_notif_size, _epout, _epin, _epsize) \
+  /* Interface Associate */\
+  8, TUSB_DESC_INTERFACE_ASSOCIATION, _itfnum, 2, TUSB_CLASS_CDC, 2, 0, 0,\
+  /* CDC Control Interface */\
+  9, TUSB_DESC_INTERFACE, _itfnum, 0, 1, TUSB_CLASS_CDC, 2, 0, _stridx,\
+  /* CDC Header */\
+  5, TUSB_DESC_CS_INTERFACE, 0, U16_TO_U8S_LE(0x0120),\
+  /* CDC Call */\
+  5, TUSB_DESC_CS_INTERFACE, 1, 0, (uint8_t)((_itfnum) + 1),\
+  /* CDC ACM: support line request + send break */\
+  4, TUSB_DESC_CS_INTERFACE, 2, 6,\
+  /* CDC Union */\
+  5, TUSB_DESC_CS_INTERFACE, 6, _itfnum, (uint8_t)((_itfnum) + 1),\
+  /* Endpoint Notification */\
+  7, TUSB_DESC_ENDPOINT, _ep_notif, 3, U16_TO_U8S_LE(_ep_notif_size), 16,\
+  /* CDC Data Interface */\
+  9, TUSB_DESC_INTERFACE, (uint8_t)((_itfnum)+1), 0, 2, TUSB_CLASS_CDC_DATA, 0, 0, 0,\
+  /* Endpoint Out */\
+  7, TUSB_DESC_ENDPOINT, _epout, 2, U16_TO_U8S_LE(_epsize), 0,\
+  /* Endpoint In */\
+  7, TUSB_DESC_ENDPOINT, _epin, 2, U16_TO_U8S_LE(_epsize), 0
+
+#define TUD_HID_DESC_LEN      (9 + 9 + 7)
+
+#define TUD_HID_DESCRIPTOR(_itfnum, _stridx, _boot_protocol, _report_desc_len, _epin, _epsize, _ep_interval) \
+  /* Interface */\
+  9, TUSB_DESC_INTERFACE, _itfnum, 0, 1, TUSB_CLASS_HID, (uint8_t)((_boot_protocol) ? 1 : 0), _boot_protocol, _stridx,\
+  /* HID descriptor */\
+  9, 0x21, U16_TO_U8S_LE(0x0111), 0, 1, 0x22, U16_TO_U8S_LE(_report_desc_len),\
+  /* Endpoint In */\
+  7, TUSB_DESC_ENDPOINT, _epin, 3, U16_TO_U8S_LE(_epsize), _ep_interval
+
+//--------------------------------------------------------------------+
+// HID
+//--------------------------------------------------------------------+
+
+enum
+{
+  HID_ITF_PROTOCOL_NONE = 0,
+  HID_ITF_PROTOCOL_KEYBOARD = 1,
+  HID_ITF_PROTOCOL_MOUSE = 2
+};
+
+typedef enum
+{
+  HID_REPORT_TYPE_INVALID = 0,
+  HID_REPORT_TYPE_INPUT,
+  HID_REPORT_TYPE_OUTPUT,
+  HID_REPORT_TYPE_FEATURE
+} hid_report_type_t;
+
+enum
+{
+  KEYBOARD_LED_NUMLOCK = 1u << 0,
+  KEYBOARD_LED_CAPSLOCK = 1u << 1,
+};
+
+enum
+{
+  MOUSE_BUTTON_LEFT = 1u << 0,
+  MOUSE_BUTTON_RIGHT = 1u << 1,
+  MOUSE_BUTTON_MIDDLE = 1u << 2,
+};
+
+typedef struct __attribute__ ((packed))
+{
+  int8_t   x;
+  int8_t   y;
+  int8_t   z;
+  int8_t   rz;
+  int8_t   rx;
+  int8_t   ry;
+  uint8_t  hat;
+  uint32_t buttons;
+} hid_gamepad_report_t;
+
+enum { GAMEPAD_BUTTON_A = 1u << 0 };
+enum { GAMEPAD_HAT_CENTERED = 0, GAMEPAD_HAT_UP = 1 };
+
+#define HID_KEY_A                             0x04
+#define HID_USAGE_CONSUMER_VOLUME_DECREMENT   0x00EA
+
+bool tud_hid_n_ready(uint8_t instance);
+bool tud_hid_n_report(uint8_t instance, uint8_t report_id, void const* report, uint16_t len);
+
+static inline bool tud_hid_ready(void) { return tud_hid_n_ready(0); }
+static inline bool tud_hid_report(uint8_t report_id, void const* report, uint16_t len) { return tud_hid_n_report(0, report_id, report, len); }
+bool tud_hid_keyboard_report(uint8_t report_id, uint8_t modifier, uint8_t const keycode[6]);
+
+// Application callbacks
+uint8_t const* tud_hid_descriptor_report_cb(uint8_t instance);
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const* report, uint16_t len);
+uint16_t tud_hid_get_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t* buffer, uint16_t reqlen);
+void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t const* buffer, uint16_t bufsize);
+
+//--------------------------------------------------------------------+
+// CDC
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  uint8_t rx_persistent : 1; // keep the RX FIFO across a bus reset
+  uint8_t tx_persistent : 1; // keep the TX FIFO across a bus reset
+} tud_cdc_configure_fifo_t;
+
+bool tud_cdc_configure_fifo(tud_cdc_configure_fifo_t const* cfg);
+bool tud_cdc_connected(void);
+uint32_t tud_cdc_available(void);
+uint32_t tud_cdc_read(void* buffer, uint32_t bufsize);
+void tud_cdc_read_flush(void);
+uint32_t tud_cdc_write(void const* buffer, uint32_t bufsize);
+uint32_t tud_cdc_write_flush(void);
+uint32_t tud_cdc_write_available(void);
+bool tud_cdc_write_clear(void);
+
+//--------------------------------------------------------------------+
+// Device
+//--------------------------------------------------------------------+
+
+bool tud_init(uint8_t rhport);
+void tud_task(void);
+bool tud_connected(void);
+bool tud_mounted(void);
+bool tud_suspended(void);
+bool tud_remote_wakeup(void);
+
+// Application callbacks
+uint8_t const* tud_descriptor_device_cb(void);
+uint8_t const* tud_descriptor_configuration_cb(uint8_t index);
+uint16_t const* tud_descriptor_string_cb(uint8_t index, uint16_t langid);
+void tud_mount_cb(void);
+void tud_umount_cb(void);
+void tud_suspend_cb(bool remote_wakeup_en);
+void tud_resume_cb(void);
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif /* FAKE_TUSB_H_ */
@@ -0,0 +1,70 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/* Board support: the button is pressed by the harness, the LED goes nowhere */
+
+#include "bsp/board_api.h"
+#include "hardware/timer.h"
+
+#include "sim.h"
+
+static bool button;
+
+void board_init(void)
+{
+}
+
+uint32_t board_millis(void)
+{
+  return (uint32_t) (time_us_64() / 1000);
+}
+
+uint32_t board_button_read(void)
+{
+  return button;
+}
+
+void board_led_write(bool state)
+{
+  (void) state;
+}
+
+size_t board_usb_get_serial(uint16_t desc_str1[], size_t max_chars)
+{
+  static char const serial[] = "50A4E0C0FFEE";
+  size_t count = 0;
+
+  while ( serial[count] && count < max_chars )
+  {
+    desc_str1[count] = (uint16_t) serial[count];
+    count++;
+  }
+  return count;
+}
+
+void sim_button(bool pressed)
+{
+  button = pressed;
+}
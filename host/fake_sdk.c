@@ -0,0 +1,380 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/* Pico SDK functions and registers used by the firmware, on the simulated clock */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico.h"
+#include "pico/time.h"
+#include "pico/flash.h"
+#include "pico/multicore.h"
+#include "hardware/timer.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/structs/scb.h"
+#include "hardware/structs/usb.h"
+#include "hardware/structs/xip_ctrl.h"
+
+#include "sim.h"
+
+//--------------------------------------------------------------------+
+// Registers
+//--------------------------------------------------------------------+
+
+// Plain memory: only what the firmware writes and reads back, the SOF counter
+// is kept current by the bus. Error and NAK latches stay clear.
+static usb_hw_t usb_regs;
+static usb_device_dpram_t usb_dpram_regs;
+static watchdog_hw_t watchdog_regs;
+static clocks_hw_t clocks_regs;
+static armv6m_scb_hw_t scb_regs;
+static xip_ctrl_hw_t xip_ctrl_regs;
+
+usb_hw_t* usb_hw = &usb_regs;
+usb_device_dpram_t* usb_dpram = &usb_dpram_regs;
+watchdog_hw_t* watchdog_hw = &watchdog_regs;
+clocks_hw_t* clocks_hw = &clocks_regs;
+armv6m_scb_hw_t* scb_hw = &scb_regs;
+xip_ctrl_hw_t* xip_ctrl_hw = &xip_ctrl_regs;
+
+//--------------------------------------------------------------------+
+// Time
+//--------------------------------------------------------------------+
+
+uint64_t time_us_64(void)
+{
+  sim_run_until(sim_time_us() + SIM_CLOCK_READ_US);
+  return sim_time_us();
+}
+
+uint32_t time_us_32(void)
+{
+  return (uint32_t) time_us_64();
+}
+
+absolute_time_t get_absolute_time(void)
+{
+  return time_us_64();
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t)
+{
+  return (uint32_t) (t / 1000);
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms)
+{
+  return time_us_64() + (uint64_t) ms * 1000;
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout)
+{
+  // nothing but the bus raises events, sleep until the timeout
+  if ( timeout > sim_time_us() ) sim_run_until(timeout);
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Flash
+//--------------------------------------------------------------------+
+
+// The image occupies the start of flash, as on the device
+#define SIM_IMAGE_SIZE  (64 * 1024)
+
+__attribute__((aligned(FLASH_SECTOR_SIZE))) uint8_t fake_flash[PICO_FLASH_SIZE_BYTES];
+
+__asm__(".globl __flash_binary_end\n"
+        ".set __flash_binary_end, fake_flash + 65536\n");
+
+_Static_assert(SIM_IMAGE_SIZE == 65536, "keep __flash_binary_end in step");
+
+static void flash_check(uint32_t offset, size_t count, uint32_t align)
+{
+  if ( offset % align || count % align || offset + count > PICO_FLASH_SIZE_BYTES || offset < SIM_IMAGE_SIZE )
+  {
+    fprintf(stderr, "sim: bad flash operation at 0x%06lx, %lu bytes\n", (unsigned long) offset, (unsigned long) count);
+    abort();
+  }
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count)
+{
+  flash_check(flash_offs, count, FLASH_SECTOR_SIZE);
+  memset(fake_flash + flash_offs, 0xFF, count);
+  sim_run_until(sim_time_us() + (uint64_t) SIM_FLASH_ERASE_US * (count / FLASH_SECTOR_SIZE));
+}
+
+void flash_range_program(uint32_t flash_offs, uint8_t const* data, size_t count)
+{
+  flash_check(flash_offs, count, FLASH_PAGE_SIZE);
+  for ( size_t i = 0; i < count; i++ ) fake_flash[flash_offs + i] &= data[i];
+  sim_run_until(sim_time_us() + (uint64_t) SIM_FLASH_PROGRAM_US * (count / FLASH_PAGE_SIZE));
+}
+
+int flash_safe_execute(void (*func)(void*), void* param, uint32_t enter_exit_timeout_ms)
+{
+  (void) enter_exit_timeout_ms;
+  func(param);
+  return PICO_OK;
+}
+
+bool flash_safe_execute_core_init(void)
+{
+  return true;
+}
+
+bool flash_safe_execute_core_deinit(void)
+{
+  return true;
+}
+
+// A new device comes with erased flash
+__attribute__((constructor)) static void flash_init(void)
+{
+  memset(fake_flash, 0xFF, sizeof(fake_flash));
+}
+
+//--------------------------------------------------------------------+
+// Watchdog
+//--------------------------------------------------------------------+
+
+static struct
+{
+  bool enabled;
+  uint32_t delay_ms;
+  uint64_t last_us;
+  uint64_t max_gap_us;
+  uint32_t reboots;
+} wdt;
+
+bool watchdog_caused_reboot(void)
+{
+  return false;
+}
+
+bool watchdog_enable_caused_reboot(void)
+{
+  return false;
+}
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug)
+{
+  (void) pause_on_debug;
+  wdt.enabled = true;
+  wdt.delay_ms = delay_ms;
+  wdt.last_us = sim_time_us();
+}
+
+void watchdog_update(void)
+{
+  if ( !wdt.enabled ) return;
+
+  uint64_t const now = sim_time_us();
+  uint64_t const gap = now - wdt.last_us;
+
+  if ( gap > wdt.max_gap_us ) wdt.max_gap_us = gap;
+  if ( gap > (uint64_t) wdt.delay_ms * 1000 ) wdt.reboots++;
+  wdt.last_us = now;
+}
+
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms)
+{
+  (void) pc;
+  (void) sp;
+  (void) delay_ms;
+  wdt.reboots++;
+}
+
+uint64_t sim_watchdog_max_gap_us(void)
+{
+  // a gap still open counts too, the firmware may be stuck in it
+  uint64_t const open = wdt.enabled ? sim_time_us() - wdt.last_us : 0;
+  return open > wdt.max_gap_us ? open : wdt.max_gap_us;
+}
+
+uint32_t sim_reboots(void)
+{
+  return wdt.reboots;
+}
+
+//--------------------------------------------------------------------+
+// Clocks
+//--------------------------------------------------------------------+
+
+static uint32_t clock_hz[CLK_COUNT] =
+{
+  [clk_ref] = 12000000,
+  [clk_sys] = 125000000,
+  [clk_peri] = 125000000,
+  [clk_usb] = 48000000,
+  [clk_adc] = 48000000,
+  [clk_rtc] = 46875,
+};
+
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq)
+{
+  (void) src;
+  (void) auxsrc;
+  if ( freq > src_freq ) return false;
+  clock_hz[clk_index] = freq;
+  return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+  return clock_hz[clk_index];
+}
+
+//--------------------------------------------------------------------+
+// DMA
+//--------------------------------------------------------------------+
+
+#define DMA_CHANNELS  12
+
+static uint16_t dma_claimed;
+
+int dma_claim_unused_channel(bool required)
+{
+  for ( int ch = 0; ch < DMA_CHANNELS; ch++ )
+  {
+    if ( !(dma_claimed & (1u << ch)) )
+    {
+      dma_claimed |= (uint16_t) (1u << ch);
+      return ch;
+    }
+  }
+
+  if ( required ) abort();
+  return -1;
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+  (void) channel;
+  return false;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel)
+{
+  (void) channel;
+}
+
+// ctrl: bits 0..1 transfer size, bit 2 read increment, bit 3 write increment
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+  (void) channel;
+  dma_channel_config const c = { .ctrl = DMA_SIZE_32 | (1u << 2) };
+  return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config* c, enum dma_channel_transfer_size size)
+{
+  c->ctrl = (c->ctrl & ~3u) | (uint32_t) size;
+}
+
+void channel_config_set_read_increment(dma_channel_config* c, bool incr)
+{
+  c->ctrl = incr ? (c->ctrl | (1u << 2)) : (c->ctrl & ~(1u << 2));
+}
+
+void channel_config_set_write_increment(dma_channel_config* c, bool incr)
+{
+  c->ctrl = incr ? (c->ctrl | (1u << 3)) : (c->ctrl & ~(1u << 3));
+}
+
+void channel_config_set_dreq(dma_channel_config* c, uint dreq)
+{
+  (void) c;
+  (void) dreq;
+}
+
+void channel_config_set_sniff_enable(dma_channel_config* c, bool sniff_enable)
+{
+  (void) c;
+  (void) sniff_enable;
+}
+
+void dma_channel_configure(uint channel, dma_channel_config const* config, volatile void* write_addr,
+                           volatile void const* read_addr, uint transfer_count, bool trigger)
+{
+  (void) channel;
+  if ( !trigger ) return;
+
+  size_t const size = 1u << (config->ctrl & 3u);
+  uint8_t* dst = (uint8_t*) (uintptr_t) write_addr;
+  uint8_t const* src = (uint8_t const*) (uintptr_t) read_addr;
+
+  for ( uint i = 0; i < transfer_count; i++ )
+  {
+    memcpy(dst, src, size);
+    if ( config->ctrl & (1u << 2) ) src += size;
+    if ( config->ctrl & (1u << 3) ) dst += size;
+  }
+}
+
+//--------------------------------------------------------------------+
+// Cores and interrupts
+//--------------------------------------------------------------------+
+
+void multicore_launch_core1(void (*entry)(void))
+{
+  (void) entry;
+}
+
+void multicore_reset_core1(void)
+{
+}
+
+void multicore_fifo_push_blocking(uint32_t data)
+{
+  (void) data;
+}
+
+bool multicore_fifo_pop_timeout_us(uint64_t timeout_us, uint32_t* out)
+{
+  (void) timeout_us;
+  (void) out;
+  return false;
+}
+
+void multicore_fifo_drain(void)
+{
+}
+
+uint32_t save_and_disable_interrupts(void)
+{
+  return 0;
+}
+
+void restore_interrupts(uint32_t status)
+{
+  (void) status;
+}
@@ -0,0 +1,695 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/* TinyUSB device stack on a simulated bus and host.
+ *
+ * The host side acts at once when the harness calls it and every 1 ms frame.
+ * What the device sees is queued as events and delivered by tud_task(), with
+ * the callbacks TinyUSB would invoke; a bus reset has no unmount callback.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tusb.h"
+#include "hardware/structs/usb.h"
+
+#include "sim.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define EVENT_QUEUE_SIZE      64
+#define CDC_PACKET_SIZE       64
+#define CDC_PACKETS_PER_FRAME 4     // each way
+#define HOST_TX_SIZE          8192  // typed text not yet sent
+#define HOST_LINE_MAX         256
+
+typedef enum
+{
+  EV_BUS_RESET = 0,
+  EV_UNPLUG,
+  EV_CONFIGURE,   // arg: configuration index
+  EV_SUSPEND,     // arg: remote wakeup enabled
+  EV_RESUME,
+  EV_LINE_STATE,  // arg: DTR
+  EV_XFER_DONE    // arg: HID instance
+} event_id_t;
+
+typedef struct
+{
+  event_id_t id;
+  uint8_t arg;
+  uint32_t generation;  // of the enumeration (configure) or of the device (transfers)
+  uint64_t at_us;       // not delivered before
+} event_t;
+
+typedef struct
+{
+  uint8_t* buf;
+  uint32_t size;
+  uint32_t head;
+  uint32_t count;
+} fifo_t;
+
+static struct
+{
+  event_t buf[EVENT_QUEUE_SIZE];
+  uint32_t head;
+  uint32_t count;
+} events;
+
+// What the device stack knows
+static struct
+{
+  bool connected;       // got a configuration since the last reset
+  bool mounted;
+  bool suspended;
+  bool remote_wakeup_support;
+  bool remote_wakeup_en;
+  bool dtr;
+  uint8_t hid_count;
+  uint32_t generation;  // bumped by every reset, drops completions from before
+
+  struct
+  {
+    bool busy;          // until the completion is delivered
+    bool armed;         // waiting for an IN token
+    uint16_t len;
+    uint8_t buf[CFG_TUD_HID_EP_BUFSIZE];
+  } ep[CFG_TUD_HID];
+
+  tud_cdc_configure_fifo_t fifo_cfg;
+  fifo_t rx;
+  fifo_t tx;
+} dev;
+
+static uint8_t dev_rx_buf[CFG_TUD_CDC_RX_BUFSIZE];
+static uint8_t dev_tx_buf[CFG_TUD_CDC_TX_BUFSIZE];
+
+// What the host does
+static struct
+{
+  sim_bus_t bus;
+  sim_bus_t resume_to;      // state before the suspend
+  uint8_t config;
+  bool allow_wakeup;
+  bool dtr;
+  uint32_t enum_generation;
+  uint64_t resume_at_us;    // remote wakeup, 0 if none
+
+  uint8_t hid_count;
+  uint8_t interval[CFG_TUD_HID];
+  sim_hid_stats_t hid[CFG_TUD_HID];
+
+  uint64_t now_us;
+  uint64_t next_frame_ns;   // in ns, so a skewed frame period need not be whole microseconds
+  uint32_t frame_ns;
+  uint32_t frame;
+
+  fifo_t tx;
+  char line[HOST_LINE_MAX];
+  uint32_t line_len;
+} host;
+
+static uint8_t host_tx_buf[HOST_TX_SIZE];
+
+//--------------------------------------------------------------------+
+// FIFO
+//--------------------------------------------------------------------+
+
+static inline uint32_t fifo_space(fifo_t const* f)
+{
+  return f->size - f->count;
+}
+
+static void fifo_push(fifo_t* f, uint8_t b)
+{
+  f->buf[(f->head + f->count) % f->size] = b;
+  f->count++;
+}
+
+static uint8_t fifo_pop(fifo_t* f)
+{
+  uint8_t const b = f->buf[f->head];
+  f->head = (f->head + 1) % f->size;
+  f->count--;
+  return b;
+}
+
+static void fifo_clear(fifo_t* f)
+{
+  f->head = f->count = 0;
+}
+
+//--------------------------------------------------------------------+
+// Events
+//--------------------------------------------------------------------+
+
+static void queue_event(event_id_t id, uint8_t arg, uint32_t generation, uint64_t delay_us)
+{
+  if ( events.count == EVENT_QUEUE_SIZE )
+  {
+    fprintf(stderr, "sim: device event queue overflow\n");
+    abort();
+  }
+
+  event_t* ev = &events.buf[(events.head + events.count) % EVENT_QUEUE_SIZE];
+  ev->id = id;
+  ev->arg = arg;
+  ev->generation = generation;
+  ev->at_us = host.now_us + delay_us;
+  events.count++;
+}
+
+static void enumerate(uint8_t config)
+{
+  host.bus = SIM_BUS_DEFAULT;
+  host.resume_at_us = 0;
+  host.enum_generation++;
+
+  queue_event(EV_BUS_RESET, 0, 0, 0);
+  queue_event(EV_CONFIGURE, config, host.enum_generation, 0);
+  if ( host.dtr ) queue_event(EV_LINE_STATE, 1, 0, 0);
+}
+
+//--------------------------------------------------------------------+
+// Device side
+//--------------------------------------------------------------------+
+
+static void device_reset(void)
+{
+  dev.connected = false;
+  dev.mounted = false;
+  dev.suspended = false;
+  dev.remote_wakeup_en = false;
+  dev.dtr = false;
+  dev.hid_count = 0;
+  dev.generation++;
+  memset(dev.ep, 0, sizeof(dev.ep));
+
+  if ( !dev.fifo_cfg.rx_persistent ) fifo_clear(&dev.rx);
+  if ( !dev.fifo_cfg.tx_persistent ) fifo_clear(&dev.tx);
+}
+
+// SET_CONFIGURATION: open the interfaces of the configuration descriptor
+static void device_configure(uint8_t config, uint32_t generation)
+{
+  (void) tud_descriptor_device_cb();
+  (void) tud_descriptor_string_cb(3, 0x0409);
+
+  uint8_t const* desc = tud_descriptor_configuration_cb(config);
+  if ( !desc ) return;
+
+  uint16_t const total = tu_unaligned_read16(desc + 2);
+  uint8_t hid_count = 0;
+  bool in_hid = false;
+
+  // the HID interfaces are numbered in descriptor order, each has one interrupt IN endpoint
+  for ( uint16_t i = 0; i < total; i += desc[i] )
+  {
+    if ( desc[i + 1] == TUSB_DESC_INTERFACE ) in_hid = desc[i + 5] == TUSB_CLASS_HID;
+
+    if ( desc[i + 1] == TUSB_DESC_ENDPOINT && in_hid && hid_count < CFG_TUD_HID )
+    {
+      if ( generation == host.enum_generation ) host.interval[hid_count] = desc[i + 6];
+      (void) tud_hid_descriptor_report_cb(hid_count);
+      hid_count++;
+    }
+  }
+
+  dev.hid_count = hid_count;
+  dev.remote_wakeup_support = desc[7] & TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP;
+  dev.connected = true;
+  dev.mounted = true;
+  dev.suspended = false;
+
+  // unless the host has started another enumeration since; it may have suspended the bus meanwhile
+  if ( generation == host.enum_generation )
+  {
+    if ( host.bus == SIM_BUS_DEFAULT ) host.bus = SIM_BUS_CONFIGURED;
+    if ( host.bus == SIM_BUS_SUSPENDED ) host.resume_to = SIM_BUS_CONFIGURED;
+    host.config = config;
+    host.hid_count = hid_count;
+  }
+
+  tud_mount_cb();
+}
+
+static void device_event(event_t const* ev)
+{
+  switch ( ev->id )
+  {
+    case EV_BUS_RESET:
+      device_reset();
+    break;
+
+    case EV_UNPLUG:
+      device_reset();
+      tud_umount_cb();
+    break;
+
+    case EV_CONFIGURE:
+      device_configure(ev->arg, ev->generation);
+    break;
+
+    case EV_SUSPEND:
+      if ( !dev.connected ) break;
+      dev.suspended = true;
+      dev.remote_wakeup_en = ev->arg;
+      tud_suspend_cb(dev.remote_wakeup_en);
+    break;
+
+    case EV_RESUME:
+      if ( !dev.connected ) break;
+      dev.suspended = false;
+      tud_resume_cb();
+    break;
+
+    case EV_LINE_STATE:
+      if ( dev.mounted ) dev.dtr = ev->arg;
+    break;
+
+    case EV_XFER_DONE:
+    {
+      uint8_t const i = ev->arg;
+      if ( ev->generation != dev.generation || !dev.ep[i].busy ) break;
+      dev.ep[i].busy = false;
+      tud_hid_report_complete_cb(i, dev.ep[i].buf, dev.ep[i].len);
+    }
+    break;
+
+    default: break;
+  }
+}
+
+//--------------------------------------------------------------------+
+// Host side, once per frame
+//--------------------------------------------------------------------+
+
+static void host_poll_hid(uint8_t i)
+{
+  host.hid[i].polls++;
+
+  if ( !dev.ep[i].armed )
+  {
+    host.hid[i].naks++;
+    return;
+  }
+
+  dev.ep[i].armed = false;
+  host.hid[i].reports++;
+  sim_on_report(i, dev.ep[i].buf, dev.ep[i].len);
+  queue_event(EV_XFER_DONE, i, dev.generation, 0);
+}
+
+static void host_receive(uint8_t ch)
+{
+  if ( ch == '\r' ) return;
+
+  if ( ch == '\n' || host.line_len == HOST_LINE_MAX - 1 )
+  {
+    host.line[host.line_len] = 0;
+    if ( host.line_len ) sim_on_cdc_line(host.line);
+    host.line_len = 0;
+    if ( ch == '\n' ) return;
+  }
+
+  host.line[host.line_len++] = (char) ch;
+}
+
+static void host_cdc(void)
+{
+  if ( !host.dtr || !dev.dtr ) return;
+
+  // OUT: the device takes a packet only while its FIFO has room for a full one
+  for ( int p = 0; p < CDC_PACKETS_PER_FRAME && host.tx.count && fifo_space(&dev.rx) >= CDC_PACKET_SIZE; p++ )
+  {
+    for ( int n = 0; n < CDC_PACKET_SIZE && host.tx.count; n++ ) fifo_push(&dev.rx, fifo_pop(&host.tx));
+  }
+
+  // IN
+  for ( int n = 0; n < CDC_PACKETS_PER_FRAME * CDC_PACKET_SIZE && dev.tx.count; n++ ) host_receive(fifo_pop(&dev.tx));
+}
+
+static void host_frame(void)
+{
+  if ( host.resume_at_us && host.now_us >= host.resume_at_us ) sim_resume();
+
+  if ( host.bus == SIM_BUS_DETACHED || host.bus == SIM_BUS_SUSPENDED ) return;
+
+  host.frame++;
+  usb_hw->sof_rd = host.frame & USB_SOF_RD_BITS;
+
+  if ( host.bus != SIM_BUS_CONFIGURED ) return;
+
+  for ( uint8_t i = 0; i < host.hid_count; i++ )
+  {
+    if ( host.frame % host.interval[i] == 0 ) host_poll_hid(i);
+  }
+
+  host_cdc();
+}
+
+//--------------------------------------------------------------------+
+// Simulation API
+//--------------------------------------------------------------------+
+
+void sim_init(uint64_t epoch_us)
+{
+  host.now_us = epoch_us;
+  host.next_frame_ns = epoch_us * 1000;
+  host.frame_ns = SIM_FRAME_US * 1000;
+  host.tx = (fifo_t) { .buf = host_tx_buf, .size = sizeof(host_tx_buf) };
+  dev.rx = (fifo_t) { .buf = dev_rx_buf, .size = sizeof(dev_rx_buf) };
+  dev.tx = (fifo_t) { .buf = dev_tx_buf, .size = sizeof(dev_tx_buf) };
+}
+
+uint64_t sim_time_us(void)
+{
+  return host.now_us;
+}
+
+void sim_frame_skew(int32_t ppm)
+{
+  host.frame_ns = (uint32_t) ((int32_t) (SIM_FRAME_US * 1000) + ppm);
+}
+
+// Time of the frame n frames after the next one
+static inline uint64_t frame_us(uint32_t n)
+{
+  return (host.next_frame_ns + (uint64_t) n * host.frame_ns + 999) / 1000;
+}
+
+void sim_run_until(uint64_t us)
+{
+  static bool running;
+
+  // a flash operation or a clock read inside a frame, the frame loop below catches up
+  if ( running )
+  {
+    if ( us > host.now_us ) host.now_us = us;
+    return;
+  }
+
+  running = true;
+  while ( frame_us(0) <= us )
+  {
+    uint64_t const at = frame_us(0);
+    if ( at > host.now_us ) host.now_us = at;
+    host.next_frame_ns += host.frame_ns;
+    host_frame();
+  }
+  if ( us > host.now_us ) host.now_us = us;
+  running = false;
+}
+
+static inline uint64_t min_u64(uint64_t x, uint64_t y)
+{
+  return (x < y) ? x : y;
+}
+
+// Time of the first frame at or after us
+static uint64_t frame_at_or_after(uint64_t us)
+{
+  if ( us <= frame_us(0) ) return frame_us(0);
+  return frame_us((uint32_t) ((us * 1000 - host.next_frame_ns + host.frame_ns - 1) / host.frame_ns));
+}
+
+uint64_t sim_next_event_us(void)
+{
+  uint64_t next = UINT64_MAX;
+
+  if ( events.count ) next = events.buf[events.head].at_us;
+  if ( host.resume_at_us ) next = min_u64(next, frame_at_or_after(host.resume_at_us));
+
+  if ( host.bus != SIM_BUS_CONFIGURED ) return next;
+
+  // the first frame numbered a multiple of the interval, host_frame() counts up before polling
+  for ( uint8_t i = 0; i < host.hid_count; i++ )
+  {
+    if ( !dev.ep[i].armed ) continue;
+    uint32_t const poll = (host.frame / host.interval[i] + 1) * host.interval[i];
+    next = min_u64(next, frame_us(poll - host.frame - 1));
+  }
+
+  if ( host.dtr && dev.dtr && (host.tx.count || dev.tx.count) ) next = min_u64(next, frame_us(0));
+
+  return next;
+}
+
+void sim_attach(uint8_t config)
+{
+  enumerate(config);
+}
+
+void sim_detach(void)
+{
+  if ( host.bus == SIM_BUS_DETACHED ) return;
+
+  host.bus = SIM_BUS_DETACHED;
+  host.resume_at_us = 0;
+  host.line_len = 0;
+  queue_event(EV_UNPLUG, 0, 0, 0);
+}
+
+void sim_bus_reset(uint8_t config)
+{
+  if ( host.bus != SIM_BUS_DETACHED ) enumerate(config);
+}
+
+void sim_suspend(bool allow_wakeup)
+{
+  if ( host.bus == SIM_BUS_DETACHED || host.bus == SIM_BUS_SUSPENDED ) return;
+
+  host.resume_to = host.bus;
+  host.bus = SIM_BUS_SUSPENDED;
+  host.allow_wakeup = allow_wakeup;
+  queue_event(EV_SUSPEND, allow_wakeup, 0, SIM_SUSPEND_DETECT_US);
+}
+
+void sim_resume(void)
+{
+  if ( host.bus != SIM_BUS_SUSPENDED ) return;
+
+  host.bus = host.resume_to;
+  host.resume_at_us = 0;
+  queue_event(EV_RESUME, 0, 0, 0);
+}
+
+void sim_cdc_open(bool open)
+{
+  if ( open == host.dtr ) return;
+
+  host.dtr = open;
+  host.line_len = 0;
+  if ( host.bus != SIM_BUS_DETACHED ) queue_event(EV_LINE_STATE, open, 0, 0);
+}
+
+void sim_cdc_send(char const* text)
+{
+  while ( *text )
+  {
+    if ( !fifo_space(&host.tx) )
+    {
+      fprintf(stderr, "sim: host CDC buffer full\n");
+      abort();
+    }
+    fifo_push(&host.tx, (uint8_t) *text++);
+  }
+}
+
+uint32_t sim_cdc_pending(void)
+{
+  return host.tx.count;
+}
+
+sim_bus_t sim_bus(void)
+{
+  return host.bus;
+}
+
+uint8_t sim_config(void)
+{
+  return host.config;
+}
+
+sim_hid_stats_t sim_hid_stats(uint8_t instance)
+{
+  return host.hid[instance];
+}
+
+//--------------------------------------------------------------------+
+// Device API
+//--------------------------------------------------------------------+
+
+bool tud_init(uint8_t rhport)
+{
+  (void) rhport;
+  return true;
+}
+
+void tud_task(void)
+{
+  // a callback may queue more, e.g. a completion that arms the next report
+  while ( events.count && events.buf[events.head].at_us <= host.now_us )
+  {
+    event_t const ev = events.buf[events.head];
+    events.head = (events.head + 1) % EVENT_QUEUE_SIZE;
+    events.count--;
+    device_event(&ev);
+  }
+}
+
+bool tud_connected(void)
+{
+  return dev.connected;
+}
+
+bool tud_mounted(void)
+{
+  return dev.mounted;
+}
+
+bool tud_suspended(void)
+{
+  return dev.suspended;
+}
+
+bool tud_remote_wakeup(void)
+{
+  if ( !(dev.suspended && dev.remote_wakeup_support && dev.remote_wakeup_en) ) return false;
+
+  // the host drives resume signalling, then restarts the frames
+  if ( host.bus == SIM_BUS_SUSPENDED && host.allow_wakeup && !host.resume_at_us )
+  {
+    host.resume_at_us = host.now_us + SIM_RESUME_US;
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// HID
+//--------------------------------------------------------------------+
+
+bool tud_hid_n_ready(uint8_t instance)
+{
+  return instance < dev.hid_count && dev.mounted && !dev.suspended && !dev.ep[instance].busy;
+}
+
+bool tud_hid_n_report(uint8_t instance, uint8_t report_id, void const* report, uint16_t len)
+{
+  if ( !tud_hid_n_ready(instance) ) return false;
+
+  uint8_t* buf = dev.ep[instance].buf;
+  uint16_t total = 0;
+
+  if ( report_id ) buf[total++] = report_id;
+  len = (uint16_t) tu_min32(len, CFG_TUD_HID_EP_BUFSIZE - total);
+  if ( len ) memcpy(buf + total, report, len);
+
+  dev.ep[instance].len = total + len;
+  dev.ep[instance].busy = true;
+  dev.ep[instance].armed = true;
+  return true;
+}
+
+bool tud_hid_keyboard_report(uint8_t report_id, uint8_t modifier, uint8_t const keycode[6])
+{
+  uint8_t report[8] = { modifier, 0 };
+  if ( keycode ) memcpy(report + 2, keycode, 6);
+  return tud_hid_report(report_id, report, sizeof(report));
+}
+
+//--------------------------------------------------------------------+
+// CDC
+//--------------------------------------------------------------------+
+
+bool tud_cdc_configure_fifo(tud_cdc_configure_fifo_t const* cfg)
+{
+  dev.fifo_cfg = *cfg;
+  return true;
+}
+
+bool tud_cdc_connected(void)
+{
+  return dev.mounted && !dev.suspended && dev.dtr;
+}
+
+uint32_t tud_cdc_available(void)
+{
+  return dev.rx.count;
+}
+
+uint32_t tud_cdc_read(void* buffer, uint32_t bufsize)
+{
+  uint8_t* p = (uint8_t*) buffer;
+  uint32_t count = 0;
+
+  while ( count < bufsize && dev.rx.count ) p[count++] = fifo_pop(&dev.rx);
+  return count;
+}
+
+void tud_cdc_read_flush(void)
+{
+  fifo_clear(&dev.rx);
+}
+
+uint32_t tud_cdc_write(void const* buffer, uint32_t bufsize)
+{
+  uint8_t const* p = (uint8_t const*) buffer;
+  uint32_t count = 0;
+
+  // with no terminal the FIFO is overwritable, so writers never block
+  for ( ; count < bufsize; count++ )
+  {
+    if ( !fifo_space(&dev.tx) )
+    {
+      if ( dev.dtr ) break;
+      (void) fifo_pop(&dev.tx);
+    }
+    fifo_push(&dev.tx, p[count]);
+  }
+  return count;
+}
+
+uint32_t tud_cdc_write_flush(void)
+{
+  // the host takes the FIFO contents every frame
+  return (dev.mounted && !dev.suspended) ? dev.tx.count : 0;
+}
+
+uint32_t tud_cdc_write_available(void)
+{
+  return fifo_space(&dev.tx);
+}
+
+bool tud_cdc_write_clear(void)
+{
+  fifo_clear(&dev.tx);
+  return true;
+}
@@ -0,0 +1,246 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/* Unit test of the object pools (pool.h), with POOL_CHECKS on.
+ *
+ *    pool_test
+ *
+ * Acquires a pool to capacity and past it, releases in a different order and
+ * acquires again, churns a random live set, checks that the usage count
+ * returns to 0 and that bad releases are refused, and that acquire and release
+ * take as many free list steps with a long free list as with a short one.
+ * Every test starts from a fresh pool. Exits 1 if a check failed.
+ */
+
+#define POOL_CHECKS 1
+
+static unsigned link_steps;
+#define POOL_LINK_STEP()  (link_steps++)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define CAPACITY  8
+
+typedef struct
+{
+  uint32_t value;
+  uint8_t pad[5];
+} item_t;
+
+POOL_DEFINE(test_pool, item_t, CAPACITY);
+
+// Large enough that a walk of the free list would show
+#define BIG_CAPACITY  256
+
+POOL_DEFINE(big_pool, item_t, BIG_CAPACITY);
+
+static unsigned failures;
+
+#define CHECK(_cond) \
+  do { \
+    if ( !(_cond) ) { fprintf(stderr, "pool_test:%d: %s\n", __LINE__, #_cond); failures++; } \
+  } while ( 0 )
+
+// Back to the state after POOL_DEFINE, so no test depends on the one before
+static void pool_reset(pool_t* pool)
+{
+  pool->free_head = POOL_NONE;
+  pool->bump = 0;
+  pool->used = 0;
+  pool->high_water = 0;
+  pool->acquired = 0;
+  pool->failed = 0;
+  pool->bad_releases = 0;
+  for ( uint16_t i = 0; i < pool->capacity; i++ ) pool->links[i] = POOL_NONE;
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+
+static void test_capacity(void)
+{
+  pool_reset(&test_pool);
+
+  item_t* items[CAPACITY];
+
+  for ( int i = 0; i < CAPACITY; i++ )
+  {
+    items[i] = test_pool_acquire();
+    CHECK(items[i] != NULL);
+    items[i]->value = (uint32_t) i;
+  }
+  CHECK(test_pool.used == CAPACITY);
+  CHECK(test_pool.high_water == CAPACITY);
+
+  // exhaustion
+  CHECK(test_pool_acquire() == NULL);
+  CHECK(test_pool.failed == 1);
+
+  // blocks are distinct and keep their contents
+  for ( int i = 0; i < CAPACITY; i++ )
+  {
+    CHECK(items[i]->value == (uint32_t) i);
+    for ( int j = 0; j < i; j++ ) CHECK(items[i] != items[j]);
+  }
+
+  // release odd then even blocks, reuse comes from the free list
+  for ( int i = 1; i < CAPACITY; i += 2 ) test_pool_release(items[i]);
+  for ( int i = 0; i < CAPACITY; i += 2 ) test_pool_release(items[i]);
+  CHECK(test_pool.used == 0);
+
+  item_t* again[CAPACITY];
+  for ( int i = 0; i < CAPACITY; i++ )
+  {
+    again[i] = test_pool_acquire();
+    bool known = false;
+    for ( int j = 0; j < CAPACITY; j++ ) known |= (again[i] == items[j]);
+    CHECK(known);
+  }
+  CHECK(test_pool_acquire() == NULL);
+
+  for ( int i = CAPACITY - 1; i >= 0; i-- ) test_pool_release(again[i]);
+  CHECK(test_pool.used == 0);
+  CHECK(test_pool.acquired == 2 * CAPACITY);
+  CHECK(test_pool.bad_releases == 0);
+}
+
+static void test_bad_release(void)
+{
+  pool_reset(&test_pool);
+
+  item_t* const a = test_pool_acquire();
+  item_t* const b = test_pool_acquire();
+  item_t outside;
+
+  test_pool_release(a);
+  test_pool_release(a);                                 // double release
+  test_pool_release(&outside);                          // foreign pointer
+  test_pool_release((item_t*) ((uint8_t*) b + 1));      // inside a block
+  CHECK(test_pool.bad_releases == 3);
+  CHECK(test_pool.used == 1);
+
+  // the free list is intact: a and then a fresh block, never a twice
+  item_t* const c = test_pool_acquire();
+  item_t* const d = test_pool_acquire();
+  CHECK(c == a);
+  CHECK(d != a && d != b);
+
+  test_pool_release(b);
+  test_pool_release(c);
+  test_pool_release(d);
+  test_pool_release(NULL);
+  CHECK(test_pool.used == 0);
+  CHECK(test_pool.bad_releases == 3);
+}
+
+// Churn with a random live set, the pool must always agree with it
+static void test_churn(void)
+{
+  item_t* live[CAPACITY] = { 0 };
+  uint32_t count = 0;
+  uint32_t rng = 1;
+
+  pool_reset(&test_pool);
+
+  for ( int n = 0; n < 100000; n++ )
+  {
+    rng = rng * 1664525u + 1013904223u;
+    uint32_t const slot = (rng >> 16) % CAPACITY;
+
+    if ( live[slot] )
+    {
+      test_pool_release(live[slot]);
+      live[slot] = NULL;
+      count--;
+    }else
+    {
+      live[slot] = test_pool_acquire();
+      CHECK(live[slot] != NULL);   // never more live than capacity
+      count++;
+    }
+    if ( test_pool.used != count ) { CHECK(test_pool.used == count); break; }
+  }
+
+  for ( int i = 0; i < CAPACITY; i++ ) test_pool_release(live[i]);
+  CHECK(test_pool.used == 0);
+  CHECK(test_pool.bad_releases == 0);
+}
+
+// Steps of one acquire and one release with 'free_count' blocks on the free list
+static void measure_steps(uint32_t free_count, unsigned* acquire_steps, unsigned* release_steps)
+{
+  static item_t* items[BIG_CAPACITY];
+
+  pool_reset(&big_pool);
+  for ( int i = 0; i < BIG_CAPACITY; i++ ) items[i] = big_pool_acquire();
+  for ( uint32_t i = 0; i < free_count; i++ ) big_pool_release(items[i]);
+
+  link_steps = 0;
+  item_t* const item = big_pool_acquire();
+  *acquire_steps = link_steps;
+  CHECK(item != NULL);
+
+  link_steps = 0;
+  big_pool_release(item);
+  *release_steps = link_steps;
+
+  CHECK(big_pool.used == BIG_CAPACITY - free_count);
+  CHECK(big_pool.bad_releases == 0);
+}
+
+// O(1): the same steps whether the pool is almost full or almost empty
+static void test_constant_time(void)
+{
+  unsigned full_acquire, full_release, empty_acquire, empty_release;
+
+  measure_steps(1, &full_acquire, &full_release);
+  measure_steps(BIG_CAPACITY - 1, &empty_acquire, &empty_release);
+
+  CHECK(full_acquire == empty_acquire);
+  CHECK(full_release == empty_release);
+  CHECK(full_acquire <= 2 && full_release <= 2);
+}
+
+int main(void)
+{
+  pool_register(&test_pool);
+  pool_register(&big_pool);
+
+  test_capacity();
+  test_bad_release();
+  test_churn();
+  test_constant_time();
+
+  printf("pool_test: %s\n", failures ? "FAILED" : "passed");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+/* Host simulation of the board and the USB host, for the soak harness (soak.c).
+ *
+ * The firmware runs unchanged on top of fake SDK and TinyUSB layers (fake/).
+ * Time is virtual: it only moves when the harness runs the bus with
+ * sim_run_until(), when the firmware sleeps, and by SIM_CLOCK_READ_US on every
+ * read of the timer, so busy-wait loops end. The harness jumps from one deadline
+ * to the next (app_next_deadline_ms(), sim_next_event_us()). The host polls the HID endpoints
+ * at their bInterval and moves CDC data once per 1 ms frame; the device side of
+ * every bus event is delivered by tud_task(), as TinyUSB does.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define SIM_CLOCK_READ_US     1       // cost of one timer read
+#define SIM_FRAME_US          1000    // full speed frame
+#define SIM_SUSPEND_DETECT_US 3000    // bus idle before the device sees a suspend
+#define SIM_RESUME_US         20000   // host drives resume this long after a remote wakeup
+#define SIM_FLASH_ERASE_US    45000   // 4 KB sector erase
+#define SIM_FLASH_PROGRAM_US  400     // 256 byte page program
+
+typedef enum
+{
+  SIM_BUS_DETACHED = 0,
+  SIM_BUS_DEFAULT,      // attached, not configured
+  SIM_BUS_CONFIGURED,
+  SIM_BUS_SUSPENDED
+} sim_bus_t;
+
+// Host side view of one HID interface
+typedef struct
+{
+  uint32_t polls;     // IN tokens sent
+  uint32_t naks;      // polls that found no report armed
+  uint32_t reports;   // reports received
+} sim_hid_stats_t;
+
+//--------------------------------------------------------------------+
+// Time
+//--------------------------------------------------------------------+
+
+// Start virtual time at epoch_us, e.g. just before board_millis() wraps
+void sim_init(uint64_t epoch_us);
+
+// Make frames ppm longer on the device clock, as if its crystal ran that much fast
+void sim_frame_skew(int32_t ppm);
+
+// Current virtual time, reading it costs nothing
+uint64_t sim_time_us(void);
+
+// Advance virtual time to us, running the bus frames on the way
+void sim_run_until(uint64_t us);
+
+// Earliest time the bus has something for the device: an event tud_task() delivers,
+// a poll of an armed endpoint, CDC data either way or a resume. UINT64_MAX if none.
+// Frames in between only count polls, the main loop can sleep through them.
+uint64_t sim_next_event_us(void);
+
+//--------------------------------------------------------------------+
+// Host actions
+//--------------------------------------------------------------------+
+
+// Plug in and enumerate with configuration index config
+void sim_attach(uint8_t config);
+void sim_detach(void);
+
+// Reset the bus and enumerate again, possibly with another configuration
+void sim_bus_reset(uint8_t config);
+
+void sim_suspend(bool allow_wakeup);
+void sim_resume(void);
+
+// Terminal opened (DTR set) or closed
+void sim_cdc_open(bool open);
+
+// Type text into the terminal, it is sent as the host gets to it
+void sim_cdc_send(char const* text);
+
+// Bytes typed but not yet accepted by the device
+uint32_t sim_cdc_pending(void);
+
+void sim_button(bool pressed);
+
+//--------------------------------------------------------------------+
+// Queries
+//--------------------------------------------------------------------+
+
+sim_bus_t sim_bus(void);
+uint8_t sim_config(void);
+sim_hid_stats_t sim_hid_stats(uint8_t instance);
+
+// Longest time between watchdog updates while it was enabled, in us
+uint64_t sim_watchdog_max_gap_us(void);
+
+// Reboots the firmware asked for, or the watchdog would have caused
+uint32_t sim_reboots(void);
+
+//--------------------------------------------------------------------+
+// Implemented by the harness
+//--------------------------------------------------------------------+
+
+// A HID report reached the host, data[0] is the report ID
+void sim_on_report(uint8_t instance, uint8_t const* data, uint16_t len);
+
+// The terminal received a complete line of console output
+void sim_on_cdc_line(char const* line);
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif /* SIM_H_ */
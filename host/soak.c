@@ -0,0 +1,593 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/* Long-duration soak test of the firmware on the simulated bus (sim.h).
+ *
+ *    soak [--hours 24] [--seed 1] [--check-hours 1] [--clock event|step] [--step-us 100] [--epoch-ms 0]
+ *         [--skew-ppm 0]
+ *
+ * Drives the main loop for hours of virtual time while a random host sends console
+ * commands, suspends and resumes, resets the bus into either configuration,
+ * unplugs and closes the terminal. At every checkpoint the host quiesces and the
+ * firmware is checked for leaked pool entries, pool exhaustion, drift between its
+ * counters and what the host received, report timing and watchdog service gaps.
+ * The event clock runs the main loop every --step-us while the firmware has work
+ * waiting and otherwise jumps to its next deadline or the next bus event, whichever
+ * comes first; the step clock always advances by --step-us. An --epoch-ms close to
+ * 4294967296 starts virtual time just before board_millis() wraps. --skew-ppm makes
+ * the device crystal run that much fast (negative: slow) against the host frame
+ * clock. Exits 1 on the first failed checkpoint.
+ */
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tusb.h"
+
+#include "app_config.h"
+#include "app_state.h"
+#include "usb_descriptors.h"
+#include "report_queue.h"
+#include "pool.h"
+#include "kv.h"
+#include "sof_clock.h"
+
+#include "sim.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define US_PER_HOUR       3600000000ull
+#define MS                1000ull
+#define S                 1000000ull
+
+#define MEASURE_US        (10 * S)
+#define QUIESCE_US        (2 * S)
+#define DEFAULT_SPEED     500     // MOTION_COUNTS_PER_S in main.c
+#define DRIFT_PPB_MAX     1000    // measured drift against --skew-ppm, on the event clock
+
+static inline uint64_t min_u64(uint64_t x, uint64_t y) { return (x < y) ? x : y; }
+
+typedef struct
+{
+  double hours;
+  uint32_t seed;
+  double check_hours;
+  bool event_clock;
+  uint32_t step_us;   // main loop period while busy
+  uint64_t epoch_ms;
+  int32_t skew_ppm;   // device crystal against the host frame clock
+} options_t;
+
+// Host actions scheduled by an earlier event, 0 if none
+typedef struct
+{
+  uint64_t resume_us;
+  uint64_t button_down_us;
+  uint64_t button_up_us;
+  uint64_t attach_us;
+  uint64_t cdc_open_us;
+  uint8_t attach_config;
+} pending_t;
+
+typedef struct
+{
+  pool_t const* pool;
+  char const* name;
+} pool_ref_t;
+
+static options_t opt = { .hours = 24, .seed = 1, .check_hours = 1, .event_clock = true, .step_us = 100 };
+static pending_t pending;
+static uint32_t rng_state;
+static uint32_t speed = DEFAULT_SPEED;  // KV_KEY_MOTION_SPEED as set by the commands sent
+
+static struct
+{
+  uint32_t commands;
+  uint32_t suspends;
+  uint32_t resets;
+  uint32_t unplugs;
+  uint32_t cdc_closes;
+  uint32_t failures;
+} count;
+
+// Reports of the motion interface seen by the host in the measurement window
+static struct
+{
+  bool active;
+  uint8_t instance;
+  uint8_t report_id;
+  uint32_t reports;
+  int64_t dx;
+} measure;
+
+static void fail(char const* fmt, ...)
+{
+  va_list ap;
+  printf("FAIL at %.3f h: ", (double) sim_time_us() / US_PER_HOUR);
+  va_start(ap, fmt);
+  vprintf(fmt, ap);
+  va_end(ap);
+  printf("\n");
+  count.failures++;
+}
+
+//--------------------------------------------------------------------+
+// Random
+//--------------------------------------------------------------------+
+
+static uint32_t rnd(void)
+{
+  uint32_t x = rng_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return rng_state = x;
+}
+
+// Uniform in [lo, hi]
+static uint64_t rnd_range(uint64_t lo, uint64_t hi)
+{
+  return lo + (((uint64_t) rnd() << 32) | rnd()) % (hi - lo + 1);
+}
+
+//--------------------------------------------------------------------+
+// Simulation callbacks
+//--------------------------------------------------------------------+
+
+void sim_on_report(uint8_t instance, uint8_t const* data, uint16_t len)
+{
+  if ( !measure.active || instance != measure.instance || len < 3 || data[0] != measure.report_id ) return;
+
+  // wire layout from hid_reports.cpp: report ID, buttons, then x as int8 or int16
+  measure.reports++;
+  if ( measure.report_id == REPORT_ID_HIRES_MOUSE ) measure.dx += (int16_t) tu_unaligned_read16(data + 2);
+  else measure.dx += (int8_t) data[2];
+}
+
+void sim_on_cdc_line(char const* line)
+{
+  static char const* const errors[] = { "unknown command", "usage:", "console busy", "store full", "out of range" };
+
+  for ( size_t i = 0; i < TU_ARRAY_SIZE(errors); i++ )
+  {
+    if ( strstr(line, errors[i]) )
+    {
+      fail("console: %s", line);
+      return;
+    }
+  }
+}
+
+//--------------------------------------------------------------------+
+// Host behaviour
+//--------------------------------------------------------------------+
+
+static bool console_ready(void)
+{
+  return sim_bus() == SIM_BUS_CONFIGURED && !pending.cdc_open_us && !sim_cdc_pending();
+}
+
+static void send_command(char const* fmt, ...)
+{
+  char line[64];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(line, sizeof(line) - 1, fmt, ap);
+  va_end(ap);
+
+  strcat(line, "\r");
+  sim_cdc_send(line);
+  count.commands++;
+}
+
+// Commands that neither reboot (update, wdt hang) nor block the loop for long
+static void random_command(void)
+{
+  static char const* const fixed[] =
+  {
+    "help", "pools", "perf", "perf reset", "clock auto", "clock high", "clock low",
+    "policy", "policy all keep", "policy all flush", "policy reports keep", "policy motion flush",
+    "policy commands keep", "wdt", "kv", "kv get 1", "flash", "log", "log dump", "crc", "dispatch",
+    "binlog", "binlog dump", "binlog follow", "binlog stop", "usb", "usb reset",
+    "stress", "stress start", "stress stop", "stress reset", "stream 4",
+    "load off", "load scratch", "load striped", "move stop", "sof", "sof reset",
+  };
+
+  if ( !console_ready() ) return;
+
+  uint32_t const r = rnd() % 100;
+
+  if ( r < 10 )
+  {
+    speed = (uint32_t) rnd_range(100, 2000);
+    send_command("kv set %u %lu", KV_KEY_MOTION_SPEED, (unsigned long) speed);
+  }else if ( r < 13 )
+  {
+    speed = DEFAULT_SPEED;
+    send_command("kv del %u", KV_KEY_MOTION_SPEED);
+  }else if ( r < 25 )
+  {
+    send_command("move %d %d %u", (int) rnd_range(0, 200) - 100, (int) rnd_range(0, 200) - 100, (unsigned) rnd_range(1, 200));
+  }else
+  {
+    send_command("%s", fixed[rnd() % TU_ARRAY_SIZE(fixed)]);
+  }
+}
+
+static void random_event(void)
+{
+  uint64_t const now = sim_time_us();
+  uint32_t const r = rnd() % 100;
+
+  if ( r < 60 )
+  {
+    random_command();
+  }else if ( r < 72 )
+  {
+    // a suspend, sometimes ended by a button press
+    uint64_t const len = rnd_range(5 * MS, 5 * S);
+    sim_suspend(rnd() & 1);
+    pending.resume_us = now + len;
+    if ( rnd() % 3 == 0 )
+    {
+      pending.button_down_us = now + rnd_range(4 * MS, len);
+      pending.button_up_us = pending.button_down_us + rnd_range(10 * MS, 200 * MS);
+    }
+    count.suspends++;
+  }else if ( r < 82 )
+  {
+    sim_bus_reset((uint8_t) (rnd() % CONFIG_COUNT));
+    count.resets++;
+  }else if ( r < 90 )
+  {
+    sim_detach();
+    pending.attach_us = now + rnd_range(10 * MS, 500 * MS);
+    pending.attach_config = (uint8_t) (rnd() % CONFIG_COUNT);
+    count.unplugs++;
+  }else
+  {
+    sim_cdc_open(false);
+    pending.cdc_open_us = now + rnd_range(10 * MS, 1 * S);
+    count.cdc_closes++;
+  }
+}
+
+static bool run_pending(uint64_t now)
+{
+  if ( pending.button_down_us && now >= pending.button_down_us )
+  {
+    sim_button(true);
+    pending.button_down_us = 0;
+  }
+
+  if ( pending.button_up_us && now >= pending.button_up_us )
+  {
+    sim_button(false);
+    pending.button_up_us = 0;
+  }
+
+  // a remote wakeup may have ended the suspend already
+  if ( pending.resume_us && (now >= pending.resume_us || sim_bus() != SIM_BUS_SUSPENDED) )
+  {
+    sim_resume();
+    pending.resume_us = 0;
+  }
+
+  if ( pending.attach_us && now >= pending.attach_us )
+  {
+    sim_attach(pending.attach_config);
+    pending.attach_us = 0;
+  }
+
+  if ( pending.cdc_open_us && now >= pending.cdc_open_us )
+  {
+    sim_cdc_open(true);
+    pending.cdc_open_us = 0;
+  }
+
+  return pending.resume_us || pending.button_down_us || pending.button_up_us || pending.attach_us || pending.cdc_open_us;
+}
+
+// Time of the next scheduled host action, UINT64_MAX if none
+static uint64_t pending_next_us(void)
+{
+  uint64_t const times[] = { pending.resume_us, pending.button_down_us, pending.button_up_us, pending.attach_us, pending.cdc_open_us };
+  uint64_t next = UINT64_MAX;
+
+  for ( size_t i = 0; i < TU_ARRAY_SIZE(times); i++ )
+  {
+    if ( times[i] && times[i] < next ) next = times[i];
+  }
+  return next;
+}
+
+// One main loop iteration, then advance virtual time, never past limit_us
+static void step(uint64_t limit_us)
+{
+  app_task();
+
+  uint64_t next = sim_time_us() + opt.step_us;
+
+  if ( opt.event_clock )
+  {
+    uint32_t const deadline_ms = app_next_deadline_ms();
+    uint64_t const now = sim_time_us();
+    int32_t const wait_ms = (int32_t) (deadline_ms - (uint32_t) (now / MS));
+
+    // nothing waiting: sleep to the start of the deadline's millisecond or the bus event
+    if ( wait_ms > 0 ) next = (now / MS + (uint64_t) wait_ms) * MS;
+    next = min_u64(next, sim_next_event_us());
+  }
+
+  sim_run_until(min_u64(next, limit_us));
+}
+
+// Run the firmware main loop for us of virtual time
+static void run_for(uint64_t us)
+{
+  uint64_t const end = sim_time_us() + us;
+
+  while ( sim_time_us() < end ) step(end);
+}
+
+//--------------------------------------------------------------------+
+// Checkpoint
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  pool_t report;
+  pool_t line;
+  pool_t macro;
+} pools_t;
+
+static void copy_pool(pool_t const* pool, void* arg)
+{
+  pools_t* p = (pools_t*) arg;
+
+  if ( !strcmp(pool->name, "report_pool") ) p->report = *pool;
+  else if ( !strcmp(pool->name, "line_pool") ) p->line = *pool;
+  else if ( !strcmp(pool->name, "macro_pool") ) p->macro = *pool;
+}
+
+static pools_t read_pools(void)
+{
+  pools_t p;
+  memset(&p, 0, sizeof(p));
+  pool_foreach(copy_pool, &p);
+  return p;
+}
+
+// Bring the host back to a known state: attached, running, terminal open, no background work
+static void quiesce(void)
+{
+  memset(&pending, 0, sizeof(pending));
+  sim_button(false);
+  if ( sim_bus() == SIM_BUS_DETACHED ) sim_attach((uint8_t) (rnd() % CONFIG_COUNT));
+  sim_resume();
+  sim_cdc_open(true);
+  run_for(200 * MS);
+
+  // one at a time, the console holds only CFG_POOL_COMMANDS lines
+  static char const* const stop[] = { "stress stop", "move stop", "binlog stop", "stream stop", "load off" };
+  for ( size_t i = 0; i < TU_ARRAY_SIZE(stop); i++ )
+  {
+    send_command("%s", stop[i]);
+    run_for(100 * MS);
+  }
+  run_for(QUIESCE_US);
+}
+
+static void checkpoint(void)
+{
+  static pools_t last;
+
+  quiesce();
+
+  // leaks: every pool entry in use is accounted for
+  pools_t const pools = read_pools();
+  uint32_t const queued = report_queue_pending(HID_INSTANCE_MOUSE) + report_queue_pending(HID_INSTANCE_HIRES);
+
+  if ( pools.report.used != queued ) fail("report_pool: %u used, %lu queued", pools.report.used, (unsigned long) queued);
+  if ( pools.line.used || sim_cdc_pending() ) fail("line_pool: %u used, %lu bytes unread", pools.line.used, (unsigned long) sim_cdc_pending());
+  if ( pools.macro.used ) fail("macro_pool: %u used after move stop", pools.macro.used);
+
+  // exhaustion: macros may run out by design ("too many macros queued"), reports and lines not
+  if ( pools.report.failed != last.report.failed ) fail("report_pool: %lu failed allocations", (unsigned long) (pools.report.failed - last.report.failed));
+  if ( pools.line.failed != last.line.failed ) fail("line_pool: %lu failed allocations", (unsigned long) (pools.line.failed - last.line.failed));
+
+  // misuse: POOL_CHECKS is on in this build
+  if ( pools.report.bad_releases || pools.line.bad_releases || pools.macro.bad_releases )
+  {
+    fail("pools: %lu bad releases", (unsigned long) (pools.report.bad_releases + pools.line.bad_releases + pools.macro.bad_releases));
+  }
+  last = pools;
+
+  if ( kv_get_u32(KV_KEY_MOTION_SPEED, DEFAULT_SPEED) != speed )
+  {
+    fail("kv: speed %lu, set to %lu", (unsigned long) kv_get_u32(KV_KEY_MOTION_SPEED, DEFAULT_SPEED), (unsigned long) speed);
+  }
+
+  // timing and counter drift: measure the demo motion the host receives
+  app_state_t before, after;
+  app_state_snapshot(&before);
+
+  bool const high_rate = before.hid.active_config == CONFIG_HIGH_RATE;
+  uint32_t const interval_ms = high_rate ? 1 : 10;  // bInterval, usb_descriptors.c
+
+  memset(&measure, 0, sizeof(measure));
+  measure.instance = high_rate ? HID_INSTANCE_HIRES : HID_INSTANCE_MOUSE;
+  measure.report_id = high_rate ? REPORT_ID_HIRES_MOUSE : REPORT_ID_MOUSE;
+  sim_hid_stats_t const polls_before = sim_hid_stats(measure.instance);
+  measure.active = true;
+  run_for(MEASURE_US);
+  measure.active = false;
+  sim_hid_stats_t const polls_after = sim_hid_stats(measure.instance);
+
+  app_state_snapshot(&after);
+
+  // one report per poll: a skewed frame clock changes the poll count, not the ratio
+  uint32_t const want_reports = polls_after.polls - polls_before.polls;
+  uint32_t const missed = polls_after.naks - polls_before.naks;
+  int64_t const want_dx = (int64_t) speed * want_reports * interval_ms / 1000;
+  int64_t const step = speed * interval_ms / 1000 + 1;
+  int64_t const queued_delta = (int64_t) (after.hid.reports_queued - before.hid.reports_queued);
+
+  if ( llabs((int64_t) measure.reports - want_reports) > 2 )
+  {
+    fail("timing: %lu reports in %llu s, want %lu", (unsigned long) measure.reports,
+         (unsigned long long) (MEASURE_US / S), (unsigned long) want_reports);
+  }
+  // flash writes wait for a frame edge after the report for it is armed, so none go missing
+  if ( missed ) fail("timing: %lu of %lu polls missed", (unsigned long) missed, (unsigned long) want_reports);
+  if ( llabs(measure.dx - want_dx) > 2 * step + 1 ) fail("motion: dx %" PRId64 ", want %" PRId64, measure.dx, want_dx);
+  if ( llabs(queued_delta - measure.reports) > 1 )
+  {
+    fail("counters: %" PRId64 " reports queued, host got %lu", queued_delta, (unsigned long) measure.reports);
+  }
+
+  // frame clock: locked after the quiet period, and the drift measured is the skew
+  // the frame edge is only found to within a main loop period, --step-us on the step clock
+  int32_t drift_ppb = 0;
+  bool const drift_valid = sof_clock_drift(&drift_ppb);
+  int64_t const drift_max = DRIFT_PPB_MAX + (opt.event_clock ? 0 : (int64_t) opt.step_us * 1000000 / CFG_SOF_DRIFT_FRAMES);
+
+  if ( !sof_clock_locked() ) fail("sof clock: not locked to the frames");
+  if ( drift_valid && llabs((int64_t) drift_ppb - (int64_t) opt.skew_ppm * 1000) > drift_max )
+  {
+    fail("sof clock: drift %.3f ppm, skew %ld ppm", drift_ppb / 1000.0, (long) opt.skew_ppm);
+  }
+
+  // watchdog: the longest service gap so far, and no reset
+  uint64_t const gap_us = sim_watchdog_max_gap_us();
+  if ( gap_us > (uint64_t) CFG_WATCHDOG_MS * 1000 ) fail("watchdog: %llu ms without an update", (unsigned long long) (gap_us / 1000));
+  if ( sim_reboots() ) fail("reboots: %lu", (unsigned long) sim_reboots());
+
+  printf("%8.2f h  config %u  reports %lu/%lu  missed %lu  drift %+.3f ppm  dx %" PRId64 "/%" PRId64 "  report pool hw %u  line pool hw %u  "
+         "wdt gap %llu ms  cmds %lu  suspends %lu  resets %lu  unplugs %lu\n",
+         (double) (sim_time_us() - opt.epoch_ms * MS) / US_PER_HOUR, before.hid.active_config,
+         (unsigned long) measure.reports, (unsigned long) want_reports, (unsigned long) missed, drift_ppb / 1000.0, measure.dx, want_dx,
+         pools.report.high_water, pools.line.high_water, (unsigned long long) (gap_us / 1000),
+         (unsigned long) count.commands, (unsigned long) count.suspends, (unsigned long) count.resets,
+         (unsigned long) count.unplugs);
+  fflush(stdout);
+}
+
+//--------------------------------------------------------------------+
+// Main
+//--------------------------------------------------------------------+
+
+static void usage(void)
+{
+  fprintf(stderr, "usage: soak [--hours h] [--seed n] [--check-hours h] [--clock event|step] [--step-us us] [--epoch-ms ms] [--skew-ppm ppm]\n");
+  exit(2);
+}
+
+static void parse_options(int argc, char* argv[])
+{
+  for ( int i = 1; i < argc; i++ )
+  {
+    if ( i + 1 >= argc ) usage();
+
+    char const* const name = argv[i];
+    char const* const value = argv[++i];
+
+    if ( !strcmp(name, "--hours") ) opt.hours = strtod(value, NULL);
+    else if ( !strcmp(name, "--seed") ) opt.seed = (uint32_t) strtoul(value, NULL, 0);
+    else if ( !strcmp(name, "--check-hours") ) opt.check_hours = strtod(value, NULL);
+    else if ( !strcmp(name, "--clock") && !strcmp(value, "event") ) opt.event_clock = true;
+    else if ( !strcmp(name, "--clock") && !strcmp(value, "step") ) opt.event_clock = false;
+    else if ( !strcmp(name, "--step-us") ) opt.step_us = (uint32_t) strtoul(value, NULL, 0);
+    else if ( !strcmp(name, "--epoch-ms") ) opt.epoch_ms = strtoull(value, NULL, 0);
+    else if ( !strcmp(name, "--skew-ppm") ) opt.skew_ppm = (int32_t) strtol(value, NULL, 0);
+    else usage();
+  }
+
+  if ( opt.hours <= 0 || opt.check_hours <= 0 || opt.step_us == 0 || opt.skew_ppm < -10000 || opt.skew_ppm > 10000 ) usage();
+}
+
+static double wall_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[])
+{
+  parse_options(argc, argv);
+  rng_state = opt.seed ? opt.seed : 1;
+
+  sim_init(opt.epoch_ms * MS);
+  sim_frame_skew(opt.skew_ppm);
+  app_init();
+
+  sim_cdc_open(true);
+  sim_attach(CONFIG_HIGH_RATE);
+
+  double const wall_start = wall_seconds();
+  uint64_t const start = sim_time_us();
+  uint64_t const end = start + (uint64_t) (opt.hours * US_PER_HOUR);
+  uint64_t const check_every = (uint64_t) (opt.check_hours * US_PER_HOUR);
+  uint64_t next_check = start + check_every;
+  uint64_t next_event = start + S;
+
+  while ( sim_time_us() < end && !count.failures )
+  {
+    step(min_u64(min_u64(end, next_check), min_u64(next_event, pending_next_us())));
+
+    uint64_t const now = sim_time_us();
+    bool const busy = run_pending(now);
+
+    if ( now >= next_check )
+    {
+      checkpoint();
+      next_check += check_every;
+      next_event = sim_time_us() + S;
+    }else if ( !busy && now >= next_event )
+    {
+      random_event();
+      next_event = now + rnd_range(10 * MS, 4 * S);
+    }
+  }
+
+  double const wall = wall_seconds() - wall_start;
+  double const sim_hours = (double) (sim_time_us() - start) / US_PER_HOUR;
+
+  printf("soak: %.2f simulated hours in %.1f s, %.1f sim-h/s (%s clock), seed %lu, %lu commands, %lu suspends, "
+         "%lu bus resets, %lu unplugs, %lu terminal closes: %s\n",
+         sim_hours, wall, wall > 0 ? sim_hours / wall : 0.0, opt.event_clock ? "event" : "step", (unsigned long) opt.seed,
+         (unsigned long) count.commands, (unsigned long) count.suspends, (unsigned long) count.resets,
+         (unsigned long) count.unplugs, (unsigned long) count.cdc_closes,
+         count.failures ? "FAILED" : "passed");
+
+  return count.failures ? 1 : 0;
+}
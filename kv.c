@@ -0,0 +1,495 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hardware/flash.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "console.h"
+#include "crc.h"
+#include "event_log.h"
+#include "flash_layout.h"
+#include "flash_service.h"
+#include "kv.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define KV_MAGIC          0x3153564Bu  // "KVS1"
+#define KV_COMPLETE       0x454E4F44u  // "DONE": sector header fully written
+#define KV_COMMIT         0x54494D43u  // "CMIT": record fully written
+#define KV_ERASED32       0xFFFFFFFFu
+#define KV_ERASED16       0xFFFFu
+
+TU_VERIFY_STATIC(CFG_KV_SECTORS >= 2, "compaction needs a spare sector");
+TU_VERIFY_STATIC(CFG_KV_MAX_KEYS < KV_ERASED16, "key range");
+
+// First bytes of every sector
+typedef struct
+{
+  uint32_t magic;
+  uint32_t seq;          // incremented by each compaction, the highest complete one is active
+  uint32_t erase_count;
+  uint32_t state;        // KV_COMPLETE once the compaction into this sector finished
+} kv_sector_hdr_t;
+
+// Record: header, value padded to 4 bytes, commit word
+typedef struct
+{
+  uint16_t key;
+  uint16_t len;          // 0: key deleted
+  uint32_t crc;          // CRC-32 of key, len and value
+} kv_rec_hdr_t;
+
+typedef struct
+{
+  uint32_t offset;       // flash offset of the record, 0: key not set
+  uint16_t len;
+  uint32_t cached;       // value if len <= 4
+} kv_index_t;
+
+static kv_index_t index_[CFG_KV_MAX_KEYS];
+
+static struct
+{
+  bool     ready;
+  uint8_t  active;       // sector index in the ring
+  uint32_t seq;
+  uint32_t write_off;    // offset of the next record within the active sector
+  uint32_t records;      // committed records in the active sector, including superseded ones
+  uint32_t compactions;
+  bool     prepared;     // the next sector of the ring is erased and begun, ready for compaction
+  bool     write_failed; // a flash operation of the current kv_set() failed
+} kv;
+
+static uint8_t page_buf[FLASH_PAGE_SIZE] __attribute__ ((aligned(4)));
+
+static char const* const key_names[KV_KEY_APP_COUNT] =
+{
+  [KV_KEY_MOTION_SPEED]       = "speed",
+  [KV_KEY_LOW_POWER_INTERVAL] = "interval",
+  [KV_KEY_UPDATE]             = "update",
+};
+
+static inline uint32_t sector_offset(uint8_t sector)
+{
+  return FLASH_KV_OFFSET + (uint32_t) sector * FLASH_SECTOR_SIZE;
+}
+
+static inline uint32_t record_size(uint32_t len)
+{
+  return sizeof(kv_rec_hdr_t) + ((len + 3u) & ~3u) + sizeof(uint32_t);
+}
+
+static inline kv_sector_hdr_t const* sector_hdr(uint8_t sector)
+{
+  return (kv_sector_hdr_t const*) FLASH_XIP(sector_offset(sector));
+}
+
+static inline uint8_t next_sector(void)
+{
+  return (uint8_t) ((kv.active + 1) % CFG_KV_SECTORS);
+}
+
+static uint32_t record_crc(uint16_t key, uint16_t len, void const* data)
+{
+  uint16_t const kl[2] = { key, len };
+  return crc32_update(crc32_update(0, kl, sizeof(kl)), data, len);
+}
+
+//--------------------------------------------------------------------+
+// Flash access
+//--------------------------------------------------------------------+
+
+// Program bytes at any offset: whole pages are written with 0xFF around the data, which
+// leaves the bytes already programmed in those pages unchanged
+static void program_bytes(uint32_t offset, void const* data, uint32_t len)
+{
+  uint8_t const* src = (uint8_t const*) data;
+
+  while ( len )
+  {
+    uint32_t const page = offset & ~(FLASH_PAGE_SIZE - 1u);
+    uint32_t const pos = offset - page;
+    uint32_t const n = tu_min32(len, FLASH_PAGE_SIZE - pos);
+
+    memset(page_buf, 0xFF, sizeof(page_buf));
+    memcpy(page_buf + pos, src, n);
+
+    if ( !flash_service_program(page, page_buf, FLASH_PAGE_SIZE) ) kv.write_failed = true;
+
+    offset += n;
+    src += n;
+    len -= n;
+  }
+}
+
+static void erase_sector(uint8_t sector)
+{
+  if ( !flash_service_erase(sector_offset(sector), FLASH_SECTOR_SIZE) ) kv.write_failed = true;
+}
+
+// Start a sector: erase it and write its header, still marked incomplete
+static void begin_sector(uint8_t sector, uint32_t seq)
+{
+  kv_sector_hdr_t const* old = sector_hdr(sector);
+  uint32_t const erases = (old->magic == KV_MAGIC) ? old->erase_count + 1 : 1;
+
+  erase_sector(sector);
+
+  kv_sector_hdr_t const hdr = { .magic = KV_MAGIC, .seq = seq, .erase_count = erases, .state = KV_ERASED32 };
+  program_bytes(sector_offset(sector), &hdr, sizeof(hdr));
+}
+
+// Begun for the next compaction by kv_task(), and nothing written after the header
+static bool sector_prepared(uint8_t sector)
+{
+  kv_sector_hdr_t const* hdr = sector_hdr(sector);
+  if ( hdr->magic != KV_MAGIC || hdr->seq != kv.seq + 1 || hdr->state != KV_ERASED32 ) return false;
+
+  uint32_t const* words = (uint32_t const*) (hdr + 1);
+  for ( uint32_t i = 0; i < (FLASH_SECTOR_SIZE - sizeof(kv_sector_hdr_t)) / 4; i++ )
+  {
+    if ( words[i] != KV_ERASED32 ) return false;
+  }
+  return true;
+}
+
+static void complete_sector(uint8_t sector)
+{
+  uint32_t const state = KV_COMPLETE;
+  program_bytes(sector_offset(sector) + offsetof(kv_sector_hdr_t, state), &state, sizeof(state));
+}
+
+// Append a committed record to the active sector, the caller checked that it fits
+static uint32_t append_record(uint16_t key, void const* data, uint16_t len)
+{
+  uint32_t const offset = sector_offset(kv.active) + kv.write_off;
+  uint32_t const size = record_size(len);
+
+  kv_rec_hdr_t const hdr = { .key = key, .len = len, .crc = record_crc(key, len, data) };
+  program_bytes(offset, &hdr, sizeof(hdr));
+  if ( len ) program_bytes(offset + sizeof(hdr), data, len);
+
+  // the record counts only once this word is in flash
+  uint32_t const commit = KV_COMMIT;
+  program_bytes(offset + size - sizeof(commit), &commit, sizeof(commit));
+
+  kv.write_off += size;
+  kv.records++;
+  return offset;
+}
+
+//--------------------------------------------------------------------+
+// Index
+//--------------------------------------------------------------------+
+
+static void index_update(uint16_t key, uint32_t offset, uint16_t len)
+{
+  kv_index_t* idx = &index_[key];
+
+  if ( !len )
+  {
+    memset(idx, 0, sizeof(*idx));
+    return;
+  }
+
+  idx->offset = offset;
+  idx->len = len;
+  idx->cached = 0;
+  if ( len <= sizeof(idx->cached) ) memcpy(&idx->cached, FLASH_XIP(offset + sizeof(kv_rec_hdr_t)), len);
+}
+
+// Rebuild the index from the committed records of the active sector
+static void scan_sector(void)
+{
+  uint32_t const base = sector_offset(kv.active);
+  uint32_t off = sizeof(kv_sector_hdr_t);
+
+  memset(index_, 0, sizeof(index_));
+  kv.records = 0;
+
+  while ( off + sizeof(kv_rec_hdr_t) <= FLASH_SECTOR_SIZE )
+  {
+    kv_rec_hdr_t const* hdr = (kv_rec_hdr_t const*) FLASH_XIP(base + off);
+
+    // end of the log
+    if ( hdr->key == KV_ERASED16 && hdr->len == KV_ERASED16 ) break;
+
+    // header torn by a power failure: the rest of the sector is unusable until compaction
+    uint32_t const size = record_size(hdr->len);
+    if ( hdr->len > CFG_KV_VALUE_MAX || off + size > FLASH_SECTOR_SIZE )
+    {
+      off = FLASH_SECTOR_SIZE;
+      break;
+    }
+
+    uint8_t const* value = FLASH_XIP(base + off + sizeof(kv_rec_hdr_t));
+    uint32_t const commit = *(uint32_t const*) FLASH_XIP(base + off + size - sizeof(uint32_t));
+
+    if ( commit == KV_COMMIT && hdr->key < CFG_KV_MAX_KEYS && hdr->crc == record_crc(hdr->key, hdr->len, value) )
+    {
+      index_update(hdr->key, base + off, hdr->len);
+      kv.records++;
+    }
+
+    off += size;
+  }
+
+  kv.write_off = off;
+}
+
+// Copy the live records into the next sector of the ring and make it the active one.
+// The value being set goes in with them (len 0 drops the key), so that a power failure
+// leaves either the old sector with the old value or the new sector with the new one.
+static void compact(uint16_t new_key, void const* new_data, uint16_t new_len)
+{
+  uint8_t const target = next_sector();
+  uint8_t value[CFG_KV_VALUE_MAX];
+
+  // usually kv_task() got to it while the bus was idle, otherwise the erase stalls it now
+  if ( !kv.prepared ) begin_sector(target, kv.seq + 1);
+  kv.prepared = false;
+
+  kv.active = target;
+  kv.write_off = sizeof(kv_sector_hdr_t);
+  kv.records = 0;
+
+  for ( uint16_t key = 0; key < CFG_KV_MAX_KEYS; key++ )
+  {
+    kv_index_t* idx = &index_[key];
+    if ( key == new_key || !idx->offset ) continue;
+
+    // live data always fits: kv_set() refuses values that would not
+    memcpy(value, FLASH_XIP(idx->offset + sizeof(kv_rec_hdr_t)), idx->len);
+    idx->offset = append_record(key, value, idx->len);
+  }
+
+  uint32_t const offset = new_len ? append_record(new_key, new_data, new_len) : 0;
+
+  // until this point a power failure leaves the old sector active
+  complete_sector(target);
+  index_update(new_key, offset, new_len);
+
+  kv.seq++;
+  kv.compactions++;
+}
+
+static uint32_t live_size(uint16_t except)
+{
+  uint32_t size = sizeof(kv_sector_hdr_t);
+
+  for ( uint16_t key = 0; key < CFG_KV_MAX_KEYS; key++ )
+  {
+    if ( key != except && index_[key].offset ) size += record_size(index_[key].len);
+  }
+
+  return size;
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+bool kv_init(void)
+{
+  extern char __flash_binary_end;
+
+  memset(&kv, 0, sizeof(kv));
+
+  // never touch flash the image lives in
+  if ( (uintptr_t) &__flash_binary_end > XIP_BASE + FLASH_DATA_OFFSET ) return false;
+
+  bool found = false;
+
+  for ( uint8_t s = 0; s < CFG_KV_SECTORS; s++ )
+  {
+    kv_sector_hdr_t const* hdr = sector_hdr(s);
+    if ( hdr->magic != KV_MAGIC || hdr->state != KV_COMPLETE ) continue;
+
+    if ( !found || (int32_t) (hdr->seq - kv.seq) > 0 )
+    {
+      kv.active = s;
+      kv.seq = hdr->seq;
+      found = true;
+    }
+  }
+
+  if ( found )
+  {
+    scan_sector();
+    kv.prepared = sector_prepared(next_sector());
+  }else
+  {
+    // blank or foreign contents: start a fresh store in the first sector
+    memset(index_, 0, sizeof(index_));
+    begin_sector(0, 1);
+    complete_sector(0);
+    kv.active = 0;
+    kv.seq = 1;
+    kv.write_off = sizeof(kv_sector_hdr_t);
+  }
+
+  kv.ready = true;
+  return true;
+}
+
+int kv_get(uint16_t key, void* buf, uint32_t bufsize)
+{
+  if ( key >= CFG_KV_MAX_KEYS || !index_[key].offset ) return -1;
+
+  kv_index_t const* idx = &index_[key];
+  memcpy(buf, FLASH_XIP(idx->offset + sizeof(kv_rec_hdr_t)), tu_min32(idx->len, bufsize));
+  return idx->len;
+}
+
+// read by report_tick_ms() and hid_task() on every report
+uint32_t __hot_path_func(kv_get_u32)(uint16_t key, uint32_t fallback)
+{
+  if ( key >= CFG_KV_MAX_KEYS || !index_[key].offset || index_[key].len > 4 ) return fallback;
+  return index_[key].cached;
+}
+
+void kv_task(void)
+{
+  if ( !kv.ready || kv.prepared || flash_service_erase_stalls() ) return;
+
+  kv.write_failed = false;
+  begin_sector(next_sector(), kv.seq + 1);
+  kv.prepared = !kv.write_failed;
+}
+
+bool kv_set(uint16_t key, void const* data, uint32_t len)
+{
+  if ( !kv.ready || key >= CFG_KV_MAX_KEYS || len > CFG_KV_VALUE_MAX ) return false;
+
+  uint32_t const size = record_size(len);
+  kv.write_failed = false;
+
+  if ( kv.write_off + size > FLASH_SECTOR_SIZE )
+  {
+    // everything live, with the new value, must fit in the sector compacted into
+    if ( live_size(key) + (len ? size : 0) > FLASH_SECTOR_SIZE ) return false;
+
+    compact(key, data, (uint16_t) len);
+  }else
+  {
+    uint32_t const offset = append_record(key, data, (uint16_t) len);
+    index_update(key, offset, (uint16_t) len);
+  }
+
+  // the flash did not take all of it: rebuild the RAM view from what is really there
+  bool const failed = kv.write_failed;
+  if ( failed ) kv_init();
+  event_log(LOG_EV_KV_WRITE, (uint8_t) key, failed);
+
+  return !failed;
+}
+
+bool kv_set_u32(uint16_t key, uint32_t value)
+{
+  return kv_set(key, &value, sizeof(value));
+}
+
+bool kv_delete(uint16_t key)
+{
+  if ( key >= CFG_KV_MAX_KEYS || !index_[key].offset ) return true;
+  return kv_set(key, NULL, 0);
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+static int parse_key(char const* name)
+{
+  for ( int k = 0; k < KV_KEY_APP_COUNT; k++ )
+  {
+    if ( key_names[k] && !strcmp(name, key_names[k]) ) return k;
+  }
+
+  char* end;
+  long const key = strtol(name, &end, 0);
+  return (*end || key < 0 || key >= CFG_KV_MAX_KEYS) ? -1 : (int) key;
+}
+
+static void print_value(uint16_t key)
+{
+  uint8_t value[CFG_KV_VALUE_MAX];
+  int const len = kv_get(key, value, sizeof(value));
+
+  console_printf("%-3u %-8s", key, (key < KV_KEY_APP_COUNT && key_names[key]) ? key_names[key] : "");
+  if ( len <= 4 ) console_printf(" %lu", (unsigned long) kv_get_u32(key, 0));
+  else for ( int i = 0; i < len; i++ ) console_printf(" %02x", value[i]);
+  console_printf("\r\n");
+}
+
+void kv_cmd(int argc, char* argv[])
+{
+  if ( !kv.ready )
+  {
+    console_printf("kv: store unavailable, image overlaps the flash data region\r\n");
+    return;
+  }
+
+  int const key = (argc >= 3) ? parse_key(argv[2]) : 0;
+
+  if ( argc >= 3 && key < 0 )
+  {
+    console_printf("kv: unknown key '%s'\r\n", argv[2]);
+    return;
+  }
+
+  if ( argc == 3 && !strcmp(argv[1], "get") )
+  {
+    if ( index_[key].offset ) print_value((uint16_t) key);
+    else console_printf("kv: %s not set\r\n", argv[2]);
+  }else if ( argc == 4 && !strcmp(argv[1], "set") )
+  {
+    if ( !kv_set_u32((uint16_t) key, (uint32_t) strtoul(argv[3], NULL, 0)) ) console_printf("kv: store full\r\n");
+  }else if ( argc == 3 && !strcmp(argv[1], "del") )
+  {
+    kv_delete((uint16_t) key);
+  }else if ( argc == 1 )
+  {
+    console_printf("sector %u of %u, seq %lu, erased %lu times, %lu/%u bytes used, %lu records, %lu compactions\r\n",
+                   kv.active, CFG_KV_SECTORS, (unsigned long) kv.seq, (unsigned long) sector_hdr(kv.active)->erase_count,
+                   (unsigned long) kv.write_off, FLASH_SECTOR_SIZE, (unsigned long) kv.records,
+                   (unsigned long) kv.compactions);
+
+    for ( uint16_t k = 0; k < CFG_KV_MAX_KEYS; k++ )
+    {
+      if ( index_[k].offset ) print_value(k);
+    }
+  }else
+  {
+    console_printf("usage: kv | kv get <key> | kv set <key> <value> | kv del <key>\r\n");
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef KV_H_
+#define KV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Log-structured key-value store in flash.
+ *
+ * Values are appended as records to the active sector; the newest record of a
+ * key wins. When the sector is full the live records are compacted into the
+ * next sector of the ring, which spreads erases over all CFG_KV_SECTORS sectors.
+ *
+ * Power-fail safety: a record only counts once its commit word, programmed after
+ * the record body, is present and its CRC matches. A compacted sector only
+ * becomes active once its header is marked complete, until then the previous
+ * sector stays in use.
+ *
+ * The RAM index maps each key to its newest record, so kv_get() is O(1). Values
+ * of up to 4 bytes are cached in the index as well, and kv_get_u32() is a
+ * __hot_path_func: it neither reads nor executes from flash and is fine on the
+ * hot path.
+ *
+ * Flash writes stall the CPU for the program/erase time (a sector erase can take
+ * tens of milliseconds), keep kv_set() off latency sensitive paths. The erase for
+ * the next compaction is done ahead by kv_task() while the bus is idle (see
+ * flash_service.h), so a kv_set() normally only programs pages.
+ */
+
+// Application keys, value layout in the comment
+typedef enum
+{
+  KV_KEY_MOTION_SPEED = 1,    // uint32: demo motion, counts per second
+  KV_KEY_LOW_POWER_INTERVAL,  // uint32: report interval of the low-power configuration in ms
+  KV_KEY_UPDATE,              // uint32 size, uint32 CRC-32: firmware image committed to the free slot
+  KV_KEY_APP_COUNT
+} kv_key_t;
+
+// Scan the store and build the index, formats it if it holds no valid sector
+bool kv_init(void);
+
+// Copy the value of 'key' into buf, return its length or -1 if not set
+int kv_get(uint16_t key, void* buf, uint32_t bufsize);
+
+// Value of a key of up to 4 bytes (little endian), 'fallback' if not set
+uint32_t kv_get_u32(uint16_t key, uint32_t fallback);
+
+// Erase and begin the sector the next compaction goes to, once the bus is idle
+void kv_task(void);
+
+bool kv_set(uint16_t key, void const* data, uint32_t len);
+bool kv_set_u32(uint16_t key, uint32_t value);
+bool kv_delete(uint16_t key);
+
+// Console: kv | kv get <key> | kv set <key> <value> | kv del <key>
+void kv_cmd(int argc, char* argv[]);
+
+#endif /* KV_H_ */
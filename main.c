@@ -30,7 +30,27 @@
 #include "bsp/board_api.h"
 #include "tusb.h"
 
+#include "app_config.h"
+#include "app_state.h"
 #include "usb_descriptors.h"
+#include "hid_reports.h"
+#include "report_queue.h"
+#include "console.h"
+#include "motion.h"
+#include "perf.h"
+#include "cdc_stream.h"
+#include "core1_load.h"
+#include "power.h"
+#include "reset_policy.h"
+#include "recovery.h"
+#include "kv.h"
+#include "event_log.h"
+#include "update.h"
+#include "crc.h"
+#include "binlog.h"
+#include "usb_stats.h"
+#include "stress.h"
+#include "sof_clock.h"
 
 //--------------------------------------------------------------------+
 // MACRO CONSTANT TYPEDEF PROTYPES
@@ -39,31 +59,74 @@
 /* Blink pattern
  * - 250 ms  : device not mounted
  * - 1000 ms : device mounted
- * - 2500 ms : device is suspended
+ * - off     : device is suspended
  */
 enum  {
   BLINK_NOT_MOUNTED = 250,
   BLINK_MOUNTED = 1000,
-  BLINK_SUSPENDED = 2500,
 };
 
-static uint32_t blink_interval_ms = BLINK_NOT_MOUNTED;
+static led_state_t __core0_data("app_state") led = { .blink_interval_ms = BLINK_NOT_MOUNTED };
+static hid_state_t __core0_data("app_state") hid = { .active_config = CONFIG_LOW_POWER };
+
+// Report interval for each configuration, matches the bInterval of its HID endpoints
+static uint32_t const report_interval_ms[CONFIG_COUNT] =
+{
+  [CONFIG_LOW_POWER] = 10,
+  [CONFIG_HIGH_RATE] = 1,
+};
+
+// Demo motion speed (right + down), independent of the report rate; KV_KEY_MOTION_SPEED overrides it
+#define MOTION_COUNTS_PER_S   500
 
 void led_blinking_task(void);
 void hid_task(void);
-void cdc_task(void) {
-    if ( tud_cdc_connected() && tud_cdc_available() ) {
-        uint8_t buf[64];
-        uint32_t count = tud_cdc_read(buf, sizeof(buf));
-        // 这里可以处理收到的数据
-        tud_cdc_write(buf, count); // 回显
-        tud_cdc_write_flush();
-    }
+static void suspend_task(void);
+
+// Report tick of the active configuration. The stored low-power interval can slow
+// reports down, never below the endpoint's bInterval.
+static inline uint32_t report_tick_ms(void)
+{
+  uint32_t const interval_ms = report_interval_ms[hid.active_config];
+  if (hid.active_config != CONFIG_LOW_POWER) return interval_ms;
+  return tu_max32(interval_ms, kv_get_u32(KV_KEY_LOW_POWER_INTERVAL, 0));
+}
+
+// Interface that carries motion in the active configuration
+static inline uint8_t motion_instance(void)
+{
+  return (hid.active_config == CONFIG_HIGH_RATE) ? HID_INSTANCE_HIRES : HID_INSTANCE_MOUSE;
+}
+
+// Work that needs the full clock: 1 ms reports or CDC traffic in either direction
+static bool pipeline_busy(void)
+{
+  return hid.active_config == CONFIG_HIGH_RATE || cdc_stream_active() || tud_cdc_available() ||
+         (tud_cdc_connected() && tud_cdc_write_available() < CFG_TUD_CDC_TX_BUFSIZE);
 }
 /*------------- MAIN -------------*/
 int main(void)
+{
+  app_init();
+
+  while (1)
+  {
+    app_task();
+  }
+}
+
+void app_init(void)
 {
   board_init();
+  power_init();
+
+  // persistent settings and log, and the outcome of a committed firmware update
+  crc_init();
+  kv_init();
+  event_log_init();
+  update_init();
+
+  reset_policy_init();
 
   // init device stack on configured roothub port
   tud_init(BOARD_TUD_RHPORT);
@@ -72,14 +135,85 @@ int main(void)
     board_init_after_tusb();
   }
 
-  while (1)
+  // register object pools
+  report_queue_init();
+  console_init();
+  motion_init();
+
+  perf_init();
+
+  // after a watchdog reset, continue from the last snapshot
+  recovery_init();
+  recovery_start();
+}
+
+void app_task(void)
+{
+  tud_task(); // tinyusb device task
+  sof_clock_task();
+  recovery_task();
+
+  if (hid.suspended)
   {
-    tud_task(); // tinyusb device task
-    led_blinking_task();
+    event_log_task();
+    kv_task();
+    update_task();
+    suspend_task();
+    return;
+  }
+
+  led_blinking_task();
+
+  usb_stats_task();
+  hid_task();
+  report_queue_service();
+
+  // a flash write waits for the next frame to start: arm this frame's report first
+  event_log_task();
+  kv_task();
+
+  console_task();
+  cdc_stream_task();
+  update_task();
+  binlog_task();
+
+  power_clock_update(pipeline_busy() ? POWER_BUSY : POWER_IDLE);
+  perf_loop_mark();
+}
+
+// Earliest deadline in the state blocks: the next report tick or LED toggle. Work that
+// is already waiting means now, as does suspend, where suspend_task() paces itself.
+// Other periodic work (snapshots, log records, clock idle) runs on the next tick, so
+// the wait is capped to keep the watchdog fed.
+uint32_t app_next_deadline_ms(void)
+{
+  uint32_t const now = board_millis();
+
+  if (hid.suspended || cdc_stream_active() || update_receiving() || tud_cdc_available() ||
+      console_pending() || binlog_pending()) return now;
 
-    hid_task();
-    cdc_task();
+  // a report to hand to a free endpoint, or in stress mode an interface to refill
+  for (uint8_t i = 0; i < CFG_TUD_HID; i++)
+  {
+    uint32_t const pending = report_queue_pending(i);
+    if (pending && tud_hid_n_ready(i)) return now;
+    if (!pending && stress_active() && i <= motion_instance()) return now;
+  }
+
+  // the report tick counts frames while locked, close enough to board_millis() for a wait
+  uint32_t wait = CFG_WATCHDOG_MS / 2;
+  uint32_t const report_wait = hid.start_ms + report_tick_ms() - sof_clock_ms();
+  if ((int32_t) report_wait <= 0) return now;
+  if (report_wait < wait) wait = report_wait;
+
+  if (led.blink_interval_ms)
+  {
+    uint32_t const led_wait = led.start_ms + led.blink_interval_ms - now;
+    if ((int32_t) led_wait <= 0) return now;
+    if (led_wait < wait) wait = led_wait;
   }
+
+  return now + wait;
 }
 
 //--------------------------------------------------------------------+
@@ -89,13 +223,35 @@ int main(void)
 // Invoked when device is mounted
 void tud_mount_cb(void)
 {
-  blink_interval_ms = BLINK_MOUNTED;
+  // TinyUSB has no callback for a bus reset, it shows as a second mount without unmount
+  if (hid.mounted)
+  {
+    event_log(LOG_EV_BUS_RESET, 0, 0);
+    reset_policy_disconnected();
+  }
+
+  hid.active_config = usb_descriptors_last_config();
+  hid.mounted = true;
+  hid.suspended = false;
+  reset_policy_connected(hid.active_config);
+  usb_stats_arm();
+  stress_pause();
+  event_log(LOG_EV_MOUNT, hid.active_config, 0);
+  BINLOG("mounted, configuration %u", hid.active_config);
+  led.blink_interval_ms = BLINK_MOUNTED;
+  perf_mounted();
 }
 
 // Invoked when device is unmounted
 void tud_umount_cb(void)
 {
-  blink_interval_ms = BLINK_NOT_MOUNTED;
+  hid.active_config = CONFIG_LOW_POWER;
+  hid.mounted = false;
+  hid.suspended = false;
+  led.blink_interval_ms = BLINK_NOT_MOUNTED;
+  reset_policy_disconnected();
+  event_log(LOG_EV_UNMOUNT, 0, 0);
+  BINLOG("unmounted");
 }
 
 // Invoked when usb bus is suspended
@@ -103,21 +259,41 @@ void tud_umount_cb(void)
 // Within 7ms, device must draw an average of current less than 2.5 mA from bus
 void tud_suspend_cb(bool remote_wakeup_en)
 {
-  (void) remote_wakeup_en;
-  blink_interval_ms = BLINK_SUSPENDED;
+  hid.suspended = true;
+  hid.remote_wakeup_en = remote_wakeup_en;
+  hid.wake_queued = false;
+  stress_pause();
+  event_log(LOG_EV_SUSPEND, remote_wakeup_en, 0);
+  BINLOG("suspended, remote wakeup %u", remote_wakeup_en);
+
+  // the LED alone would exceed the suspend current, and deep sleep needs core 1 idle
+  board_led_write(false);
+  core1_load_set(LOAD_OFF);
 }
 
 // Invoked when usb bus is resumed
 void tud_resume_cb(void)
 {
-  blink_interval_ms = tud_mounted() ? BLINK_MOUNTED : BLINK_NOT_MOUNTED;
+  uint32_t const now = board_millis();
+
+  hid.suspended = false;
+  hid.wake_queued = false;
+
+  // restart the tasks from now instead of catching up on the suspended time
+  hid.start_ms = sof_clock_ms();
+  led.start_ms = now;
+  led.blink_interval_ms = tud_mounted() ? BLINK_MOUNTED : BLINK_NOT_MOUNTED;
+
+  perf_wake();
+  event_log(LOG_EV_RESUME, 0, 0);
+  BINLOG("resumed");
 }
 
 //--------------------------------------------------------------------+
 // USB HID
 //--------------------------------------------------------------------+
 
-static void send_hid_report(uint8_t report_id, uint32_t btn)
+static void __hot_path_func(send_hid_report)(uint8_t report_id, uint32_t btn)
 {
   // skip if hid is not ready yet
   if ( !tud_hid_ready() ) return;
@@ -126,21 +302,18 @@ static void send_hid_report(uint8_t report_id, uint32_t btn)
   {
     case REPORT_ID_KEYBOARD:
     {
-      // use to avoid send multiple consecutive zero report for keyboard
-      static bool has_keyboard_key = false;
-
       if ( btn )
       {
         uint8_t keycode[6] = { 0 };
         keycode[0] = HID_KEY_A;
 
         tud_hid_keyboard_report(REPORT_ID_KEYBOARD, 0, keycode);
-        has_keyboard_key = true;
+        hid.has_keyboard_key = true;
       }else
       {
         // send empty key report if previously has key pressed
-        if (has_keyboard_key) tud_hid_keyboard_report(REPORT_ID_KEYBOARD, 0, NULL);
-        has_keyboard_key = false;
+        if (hid.has_keyboard_key) tud_hid_keyboard_report(REPORT_ID_KEYBOARD, 0, NULL);
+        hid.has_keyboard_key = false;
       }
     }
     break;
@@ -150,36 +323,32 @@ static void send_hid_report(uint8_t report_id, uint32_t btn)
       int8_t const delta = 5;
 
       // no button, right + down, no scroll, no pan
-      tud_hid_mouse_report(REPORT_ID_MOUSE, 0x00, delta, delta, 0, 0);
+      mouse_report_t const report = { .buttons = 0x00, .x = delta, .y = delta, .wheel = 0, .pan = 0 };
+      uint8_t buf[CFG_TUD_HID_EP_BUFSIZE];
+      tud_hid_report(REPORT_ID_MOUSE, buf, hid_pack_mouse(buf, &report));
     }
     break;
 
     case REPORT_ID_CONSUMER_CONTROL:
     {
-      // use to avoid send multiple consecutive zero report
-      static bool has_consumer_key = false;
-
       if ( btn )
       {
         // volume down
         uint16_t volume_down = HID_USAGE_CONSUMER_VOLUME_DECREMENT;
         tud_hid_report(REPORT_ID_CONSUMER_CONTROL, &volume_down, 2);
-        has_consumer_key = true;
+        hid.has_consumer_key = true;
       }else
       {
         // send empty key report (release key) if previously has key pressed
         uint16_t empty_key = 0;
-        if (has_consumer_key) tud_hid_report(REPORT_ID_CONSUMER_CONTROL, &empty_key, 2);
-        has_consumer_key = false;
+        if (hid.has_consumer_key) tud_hid_report(REPORT_ID_CONSUMER_CONTROL, &empty_key, 2);
+        hid.has_consumer_key = false;
       }
     }
     break;
 
     case REPORT_ID_GAMEPAD:
     {
-      // use to avoid send multiple consecutive zero report for keyboard
-      static bool has_gamepad_key = false;
-
       hid_gamepad_report_t report =
       {
         .x   = 0, .y = 0, .z = 0, .rz = 0, .rx = 0, .ry = 0,
@@ -192,13 +361,13 @@ static void send_hid_report(uint8_t report_id, uint32_t btn)
         report.buttons = GAMEPAD_BUTTON_A;
         tud_hid_report(REPORT_ID_GAMEPAD, &report, sizeof(report));
 
-        has_gamepad_key = true;
+        hid.has_gamepad_key = true;
       }else
       {
         report.hat = GAMEPAD_HAT_CENTERED;
         report.buttons = 0;
-        if (has_gamepad_key) tud_hid_report(REPORT_ID_GAMEPAD, &report, sizeof(report));
-        has_gamepad_key = false;
+        if (hid.has_gamepad_key) tud_hid_report(REPORT_ID_GAMEPAD, &report, sizeof(report));
+        hid.has_gamepad_key = false;
       }
     }
     break;
@@ -233,25 +402,108 @@ static void send_hid_report(uint8_t report_id, uint32_t btn)
 //   }
 // }
 // main.c 片段
-void hid_task(void)
+static inline int8_t clamp_int8(int16_t v)
+{
+  return (int8_t) (v > 127 ? 127 : (v < -127 ? -127 : v));
+}
+
+// Queue a mouse report on the interface that carries motion in the active configuration
+static bool __hot_path_func(queue_mouse_report)(uint8_t buttons, int16_t dx, int16_t dy, report_prio_t prio)
+{
+  queued_report_t* r = report_queue_alloc();
+  if (!r)
+  {
+    BINLOG("report pool empty, %d %d dropped", dx, dy);
+    return false;
+  }
+
+  r->instance = motion_instance();
+
+  if (r->instance == HID_INSTANCE_HIRES)
+  {
+    hires_mouse_report_t const report = { .buttons = buttons, .x = dx, .y = dy, .wheel = 0, .pan = 0 };
+    r->report_id = REPORT_ID_HIRES_MOUSE;
+    r->len = (uint8_t) hid_pack_hires_mouse(r->data, &report);
+  }else
+  {
+    mouse_report_t const report = { .buttons = buttons, .x = clamp_int8(dx), .y = clamp_int8(dy), .wheel = 0, .pan = 0 };
+    r->report_id = REPORT_ID_MOUSE;
+    r->len = (uint8_t) hid_pack_mouse(r->data, &report);
+  }
+
+  report_queue_push(r, prio);
+  hid.reports_queued++;
+  return true;
+}
+
+// Reports are paced at the interval of the active configuration, on the frame clock
+// (sof_clock.h) so they keep step with the host's polls. In the high-rate
+// configuration motion goes out on the high resolution interface every frame.
+// Motion from a running console macro overrides the demo motion. Reports are queued and
+// sent by report_queue_service(), at most one is kept pending per interface.
+void __hot_path_func(hid_task)(void)
+{
+  // stress mode feeds every interface of the configuration instead, the demo motion restarts after it
+  if (stress_active())
+  {
+    uint8_t const instances = (hid.active_config == CONFIG_HIGH_RATE) ? HID_INSTANCE_HIRES + 1 : HID_INSTANCE_MOUSE + 1;
+    stress_task(instances, report_interval_ms[hid.active_config] * 1000);
+    hid.start_ms = sof_clock_ms();
+    return;
+  }
+
+  uint32_t const interval_ms = report_tick_ms();
+  if (sof_clock_ms() - hid.start_ms < interval_ms) return;
+  hid.start_ms += interval_ms;
+
+  if (!tud_mounted() || report_queue_pending(motion_instance())) return;
+
+  int16_t dx, dy;
+  if (!motion_next(&dx, &dy))
+  {
+    hid.motion_accum += kv_get_u32(KV_KEY_MOTION_SPEED, MOTION_COUNTS_PER_S) * interval_ms;
+    dx = dy = (int16_t) (hid.motion_accum / 1000);
+    hid.motion_accum %= 1000;
+  }
+
+  queue_mouse_report(0, dx, dy, REPORT_PRIO_NORMAL);
+}
+
+// Runs instead of the other tasks while the bus is suspended: no reports are generated,
+// the button is polled and the CPU sleeps in between. A press queues a high priority
+// click that goes out before anything else once the bus resumes, and asks the host
+// to resume if it allowed remote wakeup.
+static void suspend_task(void)
 {
-  static uint32_t start_ms = 0;
-  if (board_millis() - start_ms < 10) return;
-  start_ms += 10;
+  if (!hid.wake_queued && board_button_read())
+  {
+    hid.wake_queued = queue_mouse_report(MOUSE_BUTTON_LEFT, 0, 0, REPORT_PRIO_HIGH);
 
-  if (!tud_hid_ready()) return;
-  tud_hid_mouse_report(REPORT_ID_MOUSE, 0, 5, 5, 0, 0);
+    if (hid.wake_queued && hid.remote_wakeup_en)
+    {
+      perf_wake();
+      tud_remote_wakeup();
+    }
+  }
+
+  power_clock_update(POWER_SLEEP);
+  power_wait_ms(CFG_SUSPEND_POLL_MS);
 }
 
 
 // Invoked when sent REPORT successfully to host
 // Application can use this to send the next report
 // Note: For composite reports, report[0] is report ID
-void tud_hid_report_complete_cb(uint8_t instance, uint8_t const* report, uint16_t len)
+void __hot_path_func(tud_hid_report_complete_cb)(uint8_t instance, uint8_t const* report, uint16_t len)
 {
-  (void) instance;
   (void) len;
 
+  report_queue_complete(instance);
+  stress_complete(instance);
+
+  // only the mouse interface chains through the report IDs
+  if (instance != HID_INSTANCE_MOUSE) return;
+
   uint8_t next_report_id = report[0] + 1u;
 
   if (next_report_id < REPORT_ID_COUNT)
@@ -294,13 +546,13 @@ void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_
       if (kbd_leds & KEYBOARD_LED_CAPSLOCK)
       {
         // Capslock On: disable blink, turn led on
-        blink_interval_ms = 0;
+        led.blink_interval_ms = 0;
         board_led_write(true);
       }else
       {
         // Caplocks Off: back to normal blink
         board_led_write(false);
-        blink_interval_ms = BLINK_MOUNTED;
+        led.blink_interval_ms = BLINK_MOUNTED;
       }
     }
   }
@@ -311,16 +563,45 @@ void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_
 //--------------------------------------------------------------------+
 void led_blinking_task(void)
 {
-  static uint32_t start_ms = 0;
-  static bool led_state = false;
-
   // blink is disabled
-  if (!blink_interval_ms) return;
+  if (!led.blink_interval_ms) return;
 
   // Blink every interval ms
-  if ( board_millis() - start_ms < blink_interval_ms) return; // not enough time
-  start_ms += blink_interval_ms;
+  if ( board_millis() - led.start_ms < led.blink_interval_ms) return; // not enough time
+  led.start_ms += led.blink_interval_ms;
+
+  board_led_write(led.led_on);
+  led.led_on = !led.led_on; // toggle
+}
+
+//--------------------------------------------------------------------+
+// State snapshot
+//--------------------------------------------------------------------+
+
+void app_state_snapshot(app_state_t* snap)
+{
+  snap->led = led;
+  snap->hid = hid;
+}
+
+void app_state_restore(app_state_t const* snap)
+{
+  uint32_t const now = board_millis();
+
+  led = snap->led;
+  hid = snap->hid;
+
+  // timestamps of the snapshot belong to another time base (before a reset or a long suspend)
+  led.start_ms = now;
+  hid.start_ms = sof_clock_ms();
+
+  // bus state is rebuilt by the USB callbacks, not restored
+  led.blink_interval_ms = tud_mounted() ? BLINK_MOUNTED : BLINK_NOT_MOUNTED;
+  hid.active_config = tud_mounted() ? usb_descriptors_last_config() : CONFIG_LOW_POWER;
+  hid.mounted = tud_mounted();
+  hid.suspended = tud_suspended();
+  hid.remote_wakeup_en = false;
+  hid.wake_queued = false;
 
-  board_led_write(led_state);
-  led_state = 1 - led_state; // toggle
+  board_led_write(led.led_on);
 }
@@ -0,0 +1,161 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_config.h"
+#include "console.h"
+#include "motion.h"
+#include "pool.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+typedef struct motion_macro
+{
+  struct motion_macro* next;
+  int16_t  dx;
+  int16_t  dy;
+  uint32_t remaining; // reports left
+} motion_macro_t;
+
+POOL_DEFINE(macro_pool, motion_macro_t, CFG_POOL_MACROS);
+
+static motion_macro_t* head;
+static motion_macro_t* tail;
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void motion_init(void)
+{
+  pool_register(&macro_pool);
+}
+
+bool motion_start(int16_t dx, int16_t dy, uint32_t reports)
+{
+  if ( !reports ) return true;
+
+  motion_macro_t* m = macro_pool_acquire();
+  if ( !m ) return false;
+
+  m->next = NULL;
+  m->dx = dx;
+  m->dy = dy;
+  m->remaining = reports;
+
+  if ( tail ) tail->next = m;
+  else head = m;
+  tail = m;
+
+  return true;
+}
+
+bool __hot_path_func(motion_next)(int16_t* dx, int16_t* dy)
+{
+  motion_macro_t* m = head;
+  if ( !m ) return false;
+
+  *dx = m->dx;
+  *dy = m->dy;
+
+  if ( --m->remaining == 0 )
+  {
+    head = m->next;
+    if ( !head ) tail = NULL;
+    macro_pool_release(m);
+  }
+
+  return true;
+}
+
+uint32_t motion_stop_all(void)
+{
+  uint32_t count = 0;
+
+  while ( head )
+  {
+    motion_macro_t* next = head->next;
+    macro_pool_release(head);
+    head = next;
+    count++;
+  }
+  tail = NULL;
+
+  return count;
+}
+
+uint32_t motion_snapshot(motion_step_t* steps, uint32_t max)
+{
+  uint32_t count = 0;
+
+  for ( motion_macro_t const* m = head; m && count < max; m = m->next, count++ )
+  {
+    steps[count].dx = m->dx;
+    steps[count].dy = m->dy;
+    steps[count].remaining = m->remaining;
+  }
+
+  return count;
+}
+
+void motion_restore(motion_step_t const* steps, uint32_t count)
+{
+  for ( uint32_t i = 0; i < count; i++ ) motion_start(steps[i].dx, steps[i].dy, steps[i].remaining);
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void motion_cmd_move(int argc, char* argv[])
+{
+  if ( argc == 2 && !strcmp(argv[1], "stop") )
+  {
+    motion_stop_all();
+    return;
+  }
+
+  if ( argc != 4 )
+  {
+    console_printf("usage: move <dx> <dy> <reports> | move stop\r\n");
+    return;
+  }
+
+  long const dx = strtol(argv[1], NULL, 0);
+  long const dy = strtol(argv[2], NULL, 0);
+  long const n  = strtol(argv[3], NULL, 0);
+
+  if ( dx < -32767 || dx > 32767 || dy < -32767 || dy > 32767 || n < 0 )
+  {
+    console_printf("move: out of range\r\n");
+    return;
+  }
+
+  if ( !motion_start((int16_t) dx, (int16_t) dy, (uint32_t) n) ) console_printf("move: too many macros queued\r\n");
+}
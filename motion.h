@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef MOTION_H_
+#define MOTION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Motion macros: "move dx dy n" adds (dx, dy) to n consecutive reports.
+ * Macros run one after another in the order they were queued, each one is a
+ * pool allocated context holding its remaining step count.
+ */
+
+// Queued macro, as kept in a snapshot
+typedef struct
+{
+  int16_t  dx;
+  int16_t  dy;
+  uint32_t remaining;
+} motion_step_t;
+
+void motion_init(void);
+
+// Queue a macro, false if the macro pool is exhausted
+bool motion_start(int16_t dx, int16_t dy, uint32_t reports);
+
+// Take the next step of the running macro, false if no macro is running
+bool motion_next(int16_t* dx, int16_t* dy);
+
+// Cancel all macros, return how many were cancelled
+uint32_t motion_stop_all(void);
+
+// Copy up to 'max' queued macros, running one first, return how many were copied
+uint32_t motion_snapshot(motion_step_t* steps, uint32_t max);
+
+// Queue the macros of a snapshot behind any already queued
+void motion_restore(motion_step_t const* steps, uint32_t count);
+
+// Console: move <dx> <dy> <reports> | move stop
+void motion_cmd_move(int argc, char* argv[]);
+
+#endif /* MOTION_H_ */
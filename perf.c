@@ -0,0 +1,200 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "hardware/address_mapped.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "hardware/timer.h"
+
+#include "app_config.h"
+#include "console.h"
+#include "perf.h"
+
+#ifndef PICO_COPY_TO_RAM
+#define PICO_COPY_TO_RAM 0
+#endif
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t min_us;
+  uint32_t max_us;
+  uint64_t sum_us;
+} perf_stat_t;
+
+static perf_stat_t loop_stat;
+static perf_stat_t report_stat;
+static perf_stat_t wake_stat;
+static uint32_t wake_us;
+static bool wake_pending;
+static uint32_t last_mark_us;
+static uint64_t mount_us; // 0 until the first mount
+static uint32_t image_size;
+static uint32_t image_us;
+
+// End of the binary in flash, from the SDK linker scripts
+extern char __flash_binary_end;
+
+static void stat_reset(perf_stat_t* stat)
+{
+  memset(stat, 0, sizeof(*stat));
+  stat->min_us = UINT32_MAX;
+}
+
+static inline void stat_add(perf_stat_t* stat, uint32_t us)
+{
+  stat->count++;
+  stat->sum_us += us;
+  if ( us < stat->min_us ) stat->min_us = us;
+  if ( us > stat->max_us ) stat->max_us = us;
+}
+
+static void stat_print(char const* name, perf_stat_t const* stat)
+{
+  if ( !stat->count )
+  {
+    console_printf("%-6s no samples\r\n", name);
+    return;
+  }
+
+  console_printf("%-6s n=%lu min=%lu avg=%lu max=%lu us, jitter %lu us\r\n", name,
+                 (unsigned long) stat->count, (unsigned long) stat->min_us,
+                 (unsigned long) (stat->sum_us / stat->count), (unsigned long) stat->max_us,
+                 (unsigned long) (stat->max_us - stat->min_us));
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void perf_init(void)
+{
+  perf_reset();
+}
+
+void perf_reset(void)
+{
+  stat_reset(&loop_stat);
+  stat_reset(&report_stat);
+  stat_reset(&wake_stat);
+  last_mark_us = time_us_32();
+
+  // writing any value clears the counters
+  xip_ctrl_hw->ctr_hit = 0;
+  xip_ctrl_hw->ctr_acc = 0;
+}
+
+void __hot_path_func(perf_loop_mark)(void)
+{
+  uint32_t const now = time_us_32();
+  stat_add(&loop_stat, now - last_mark_us);
+  last_mark_us = now;
+}
+
+void __hot_path_func(perf_report_done)(uint32_t latency_us)
+{
+  stat_add(&report_stat, latency_us);
+
+  if ( wake_pending )
+  {
+    wake_pending = false;
+    stat_add(&wake_stat, time_us_32() - wake_us);
+  }
+}
+
+void perf_wake(void)
+{
+  if ( wake_pending ) return;
+
+  wake_pending = true;
+  wake_us = time_us_32();
+}
+
+void perf_mounted(void)
+{
+  if ( !mount_us ) mount_us = time_us_64();
+}
+
+// Time to read the whole image through the uncached XIP alias: a lower bound for the
+// copy the boot code of a copy_to_ram build does before the timer starts. Blocks the
+// main loop for tens of milliseconds, so only done on request, never during boot where
+// it would count towards the mount time and delay every warm restart.
+static void measure_image(void)
+{
+  uint32_t const len = (uint32_t) ((uintptr_t) &__flash_binary_end - XIP_BASE);
+  uint32_t const* p = (uint32_t const*) XIP_NOCACHE_NOALLOC_BASE;
+  uint32_t sum = 0;
+
+  uint32_t const start = time_us_32();
+  for ( uint32_t i = 0; i < len / 4; i++ ) sum += p[i];
+  image_us = time_us_32() - start;
+  image_size = len;
+
+  // keep the loop from being optimised away
+  __asm volatile ("" : : "r" (sum));
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void perf_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 && !strcmp(argv[1], "reset") )
+  {
+    perf_reset();
+    return;
+  }
+
+  if ( argc == 2 && !strcmp(argv[1], "image") )
+  {
+    measure_image();
+    console_printf("image  %lu bytes, %lu us to read uncached\r\n", (unsigned long) image_size, (unsigned long) image_us);
+    return;
+  }
+
+  // counters saturate rather than wrap
+  uint32_t const hit = xip_ctrl_hw->ctr_hit;
+  uint32_t const acc = xip_ctrl_hw->ctr_acc;
+
+  console_printf("code   %s\r\n", PICO_COPY_TO_RAM ? "copied to SRAM" :
+                 (CFG_RAM_HOT_PATHS ? "hot paths in SRAM" : "all in flash"));
+  stat_print("loop", &loop_stat);
+  stat_print("report", &report_stat);
+  stat_print("wake", &wake_stat);
+
+  if ( mount_us ) console_printf("boot   mounted %lu us after timer start\r\n", (unsigned long) mount_us);
+
+  if ( image_us ) console_printf("image  %lu bytes, %lu us to read uncached\r\n", (unsigned long) image_size, (unsigned long) image_us);
+
+  console_printf("xip    %lu/%lu cache hits (%lu.%lu%%)\r\n", (unsigned long) hit, (unsigned long) acc,
+                 (unsigned long) (acc ? (uint64_t) hit * 100 / acc : 0),
+                 (unsigned long) (acc ? (uint64_t) hit * 1000 / acc % 10 : 0));
+}
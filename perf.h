@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef PERF_H_
+#define PERF_H_
+
+#include <stdint.h>
+
+/* Timing statistics for comparing firmware variants, plus the XIP cache hit counters.
+ *
+ * - loop   : main loop iteration time, its spread (max - min) is the loop jitter
+ * - report : time from a report being queued to its transfer completing
+ * - wake   : time from a remote wakeup request (or the host's resume) to the
+ *            first report completing after it
+ * - boot   : time from the timer starting (early in runtime init, after the
+ *            boot code copied a copy_to_ram image) to the first mount
+ * - image  : time to read the whole image uncached, measured by "perf image"
+ *
+ * The "perf" console command prints everything, "perf reset" starts a new
+ * measurement of loop, report and wake (boot is kept). "perf image" blocks the
+ * main loop for tens of milliseconds while it reads the image.
+ */
+
+void perf_init(void);
+
+void perf_reset(void);
+
+// Record the end of one main loop iteration
+void perf_loop_mark(void);
+
+// Record the queued-to-completed time of one report
+void perf_report_done(uint32_t latency_us);
+
+// Record the first mount since boot
+void perf_mounted(void);
+
+// Start timing a wake (remote wakeup request or resume), the next completed report ends it
+void perf_wake(void);
+
+// Console: perf | perf reset
+void perf_cmd(int argc, char* argv[]);
+
+#endif /* PERF_H_ */
@@ -0,0 +1,48 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "pool.h"
+
+#ifndef CFG_POOL_REGISTRY_MAX
+#define CFG_POOL_REGISTRY_MAX   8
+#endif
+
+static pool_t* registry[CFG_POOL_REGISTRY_MAX];
+static uint8_t registry_count;
+
+void pool_register(pool_t* pool)
+{
+  for ( uint8_t i = 0; i < registry_count; i++ )
+  {
+    if ( registry[i] == pool ) return;
+  }
+
+  if ( registry_count < CFG_POOL_REGISTRY_MAX ) registry[registry_count++] = pool;
+}
+
+void pool_foreach(void (*fn)(pool_t const* pool, void* arg), void* arg)
+{
+  for ( uint8_t i = 0; i < registry_count; i++ ) fn(registry[i], arg);
+}
@@ -0,0 +1,160 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Fixed-size object pools.
+ *
+ * Each pool owns a static array of 'capacity' objects. Blocks that were never
+ * handed out are taken from a bump index, released blocks go to a free list of
+ * indices, so both acquire and release are O(1) with no initialisation pass and
+ * no heap. Usage, high-water mark and failed acquires are tracked per pool.
+ *
+ *   POOL_DEFINE(report_pool, queued_report_t, CFG_POOL_REPORTS);
+ *   queued_report_t* r = report_pool_acquire();   // NULL when exhausted
+ *   report_pool_release(r);
+ *
+ * Pools are not interrupt safe, use them from the main loop only.
+ *
+ * With POOL_CHECKS (default in builds without NDEBUG) a release of a pointer
+ * outside the storage, not on a block boundary, or of a block that is not
+ * handed out (double release) is refused and counted in bad_releases, so the
+ * free list and the usage count stay intact.
+ */
+
+#ifndef POOL_CHECKS
+  #ifdef NDEBUG
+    #define POOL_CHECKS   0
+  #else
+    #define POOL_CHECKS   1
+  #endif
+#endif
+
+// Called on every access to the free list links, the host test counts them to check
+// that acquire and release take the same steps however long the free list is
+#ifndef POOL_LINK_STEP
+  #define POOL_LINK_STEP()
+#endif
+
+#define POOL_NONE     0xFFFFu
+#define POOL_IN_USE   0xFFFEu   // link of a block that is handed out
+
+typedef struct
+{
+  char const* name;
+  uint8_t*    storage;
+  uint16_t*   links;       // free list: index of next free block
+  uint16_t    block_size;
+  uint16_t    capacity;
+
+  uint16_t    free_head;   // first released block, POOL_NONE if none
+  uint16_t    bump;        // blocks [bump, capacity) were never handed out
+  uint16_t    used;
+  uint16_t    high_water;
+  uint32_t    acquired;    // total successful acquires
+  uint32_t    failed;      // acquires refused because the pool was empty
+  uint32_t    bad_releases; // releases refused by POOL_CHECKS
+} pool_t;
+
+#define POOL_INIT(_name, _storage, _links, _capacity) \
+  { .name = (_name), .storage = (uint8_t*) (_storage), .links = (_links), \
+    .block_size = sizeof((_storage)[0]), .capacity = (_capacity), .free_head = POOL_NONE }
+
+// Define a pool of 'capacity' objects of 'type' with typed accessors
+// <name>_acquire(), <name>_release() and the pool_t itself as <name>
+#define POOL_DEFINE(_name, _type, _capacity) \
+  POOL_DEFINE_IN(_name, _type, _capacity, )
+
+// Same, with the pool and its storage placed by '_place', e.g __core0_data("reports")
+#define POOL_DEFINE_IN(_name, _type, _capacity, _place) \
+  _Static_assert((_capacity) > 0 && (_capacity) < POOL_IN_USE, "bad pool capacity"); \
+  static _type     _place _name##_storage[_capacity]; \
+  static uint16_t  _place _name##_links[_capacity]; \
+  static pool_t    _place _name = POOL_INIT(#_name, _name##_storage, _name##_links, _capacity); \
+  static inline _type* _name##_acquire(void) { return (_type*) pool_acquire(&_name); } \
+  static inline void _name##_release(_type* obj) { pool_release(&_name, obj); }
+
+static inline void* pool_acquire(pool_t* pool)
+{
+  uint16_t idx;
+
+  if ( pool->free_head != POOL_NONE )
+  {
+    idx = pool->free_head;
+    POOL_LINK_STEP();
+    pool->free_head = pool->links[idx];
+  }else if ( pool->bump < pool->capacity )
+  {
+    idx = pool->bump++;
+  }else
+  {
+    pool->failed++;
+    return NULL;
+  }
+
+  POOL_LINK_STEP();
+  pool->links[idx] = POOL_IN_USE;
+  pool->used++;
+  pool->acquired++;
+  if ( pool->used > pool->high_water ) pool->high_water = pool->used;
+
+  return pool->storage + (size_t) idx * pool->block_size;
+}
+
+static inline void pool_release(pool_t* pool, void* obj)
+{
+  if ( !obj ) return;
+
+#if POOL_CHECKS
+  uintptr_t const offset = (uintptr_t) obj - (uintptr_t) pool->storage;
+  POOL_LINK_STEP();
+  if ( offset >= (uintptr_t) pool->capacity * pool->block_size || offset % pool->block_size ||
+       pool->links[offset / pool->block_size] != POOL_IN_USE )
+  {
+    pool->bad_releases++;
+    return;
+  }
+#endif
+
+  uint16_t const idx = (uint16_t) (((uint8_t*) obj - pool->storage) / pool->block_size);
+
+  POOL_LINK_STEP();
+  pool->links[idx] = pool->free_head;
+  pool->free_head = idx;
+  pool->used--;
+}
+
+// Register a pool so it shows up in pool_foreach(), call once from the owner's init
+void pool_register(pool_t* pool);
+
+// Iterate registered pools, e.g for telemetry
+void pool_foreach(void (*fn)(pool_t const* pool, void* arg), void* arg);
+
+#endif /* POOL_H_ */
@@ -0,0 +1,208 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "hardware/clocks.h"
+#include "hardware/structs/scb.h"
+#include "hardware/timer.h"
+#include "pico/time.h"
+
+#include "app_config.h"
+#include "binlog.h"
+#include "console.h"
+#include "power.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+typedef enum
+{
+  CLOCK_AUTO = 0,
+  CLOCK_PIN_HIGH,
+  CLOCK_PIN_LOW,
+} clock_mode_t;
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t last_us;
+  uint32_t max_us;
+} transition_stat_t;
+
+typedef struct
+{
+  uint32_t full_hz;       // pll_sys
+  uint32_t low_hz;        // pll_usb
+  clock_mode_t mode;
+  bool     high;
+  uint32_t idle_since_ms; // start of the current idle stretch
+  uint32_t switched_ms;   // time of the last switch, for residency
+  uint32_t high_ms;
+  uint32_t low_ms;
+  transition_stat_t up;
+  transition_stat_t down;
+} clock_state_t;
+
+static clock_state_t clk;
+
+static char const* const mode_names[] = { "auto", "high", "low" };
+
+//--------------------------------------------------------------------+
+// Clock switching
+//--------------------------------------------------------------------+
+
+static void clock_set(bool high)
+{
+  if ( high == clk.high ) return;
+
+  uint32_t const now_ms = to_ms_since_boot(get_absolute_time());
+  uint32_t const t0 = time_us_32();
+
+  // glitchless: clock_configure() parks clk_sys on clk_ref while the aux mux changes
+  if ( high )
+  {
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, clk.full_hz, clk.full_hz);
+  }else
+  {
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, clk.low_hz, clk.low_hz);
+  }
+
+  uint32_t const us = time_us_32() - t0;
+  transition_stat_t* stat = high ? &clk.up : &clk.down;
+  stat->count++;
+  stat->last_us = us;
+  if ( us > stat->max_us ) stat->max_us = us;
+  BINLOG("clk_sys %u Hz, switch took %u us", high ? clk.full_hz : clk.low_hz, us);
+
+  if ( clk.high ) clk.high_ms += now_ms - clk.switched_ms;
+  else clk.low_ms += now_ms - clk.switched_ms;
+  clk.switched_ms = now_ms;
+
+  clk.high = high;
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void power_init(void)
+{
+  memset(&clk, 0, sizeof(clk));
+  clk.full_hz = clock_get_hz(clk_sys);
+  clk.low_hz  = clock_get_hz(clk_usb);
+  clk.high    = true;
+
+  // keep peripheral clocks (UART, SPI) independent of clk_sys scaling
+  clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, clk.full_hz, clk.full_hz);
+}
+
+void power_clock_update(power_demand_t demand)
+{
+  if ( clk.mode != CLOCK_AUTO )
+  {
+    clock_set(clk.mode == CLOCK_PIN_HIGH);
+    return;
+  }
+
+  uint32_t const now_ms = to_ms_since_boot(get_absolute_time());
+
+  switch ( demand )
+  {
+    case POWER_BUSY:
+      clk.idle_since_ms = now_ms;
+      clock_set(true);
+    break;
+
+    case POWER_IDLE:
+      if ( now_ms - clk.idle_since_ms >= CFG_CLOCK_IDLE_MS ) clock_set(false);
+    break;
+
+    case POWER_SLEEP:
+    default:
+      clock_set(false);
+    break;
+  }
+}
+
+void power_wait_ms(uint32_t ms)
+{
+#if CFG_SUSPEND_DEEP_SLEEP
+  uint32_t const en0 = clocks_hw->sleep_en0;
+  uint32_t const en1 = clocks_hw->sleep_en1;
+
+  // clocks kept while both cores sleep: the timer for the timeout, the USB controller for resume and reset
+  clocks_hw->sleep_en0 = 0;
+  clocks_hw->sleep_en1 = CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS |
+                         CLOCKS_SLEEP_EN1_CLK_SYS_USBCTRL_BITS | CLOCKS_SLEEP_EN1_CLK_USB_USBCTRL_BITS;
+  scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+
+  best_effort_wfe_or_timeout(make_timeout_time_ms(ms));
+
+  scb_hw->scr &= ~M0PLUS_SCR_SLEEPDEEP_BITS;
+  clocks_hw->sleep_en0 = en0;
+  clocks_hw->sleep_en1 = en1;
+#else
+  best_effort_wfe_or_timeout(make_timeout_time_ms(ms));
+#endif
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void power_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 )
+  {
+    for ( unsigned i = 0; i < sizeof(mode_names) / sizeof(mode_names[0]); i++ )
+    {
+      if ( !strcmp(argv[1], mode_names[i]) )
+      {
+        clk.mode = (clock_mode_t) i;
+        clk.idle_since_ms = to_ms_since_boot(get_absolute_time());
+        if ( clk.mode != CLOCK_AUTO ) clock_set(clk.mode == CLOCK_PIN_HIGH);
+        return;
+      }
+    }
+
+    console_printf("usage: clock [auto|high|low]\r\n");
+    return;
+  }
+
+  uint32_t const now_ms = to_ms_since_boot(get_absolute_time());
+  uint32_t const high_ms = clk.high_ms + (clk.high ? now_ms - clk.switched_ms : 0);
+  uint32_t const low_ms  = clk.low_ms + (clk.high ? 0 : now_ms - clk.switched_ms);
+
+  console_printf("clk_sys %lu Hz (%s), %lu ms high, %lu ms low\r\n", (unsigned long) clock_get_hz(clk_sys),
+                 mode_names[clk.mode], (unsigned long) high_ms, (unsigned long) low_ms);
+  console_printf("up   %lu switches, last %lu us, max %lu us\r\n", (unsigned long) clk.up.count,
+                 (unsigned long) clk.up.last_us, (unsigned long) clk.up.max_us);
+  console_printf("down %lu switches, last %lu us, max %lu us\r\n", (unsigned long) clk.down.count,
+                 (unsigned long) clk.down.last_us, (unsigned long) clk.down.max_us);
+}
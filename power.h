@@ -0,0 +1,62 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <stdint.h>
+
+/* Power management: system clock scaling and low power waiting.
+ *
+ * clk_sys runs from pll_sys (full speed) while there is work and from pll_usb
+ * (48 MHz, the lowest clock the USB controller allows) while idle. Both PLLs keep
+ * running, clk_sys switches glitchlessly through its aux mux in a few
+ * microseconds. clk_peri is fed from pll_sys directly so UART baud rates do not
+ * follow clk_sys. The clock is raised as soon as there is demand and lowered only
+ * after CFG_CLOCK_IDLE_MS without any, or right away when the bus is suspended.
+ *
+ * power_wait_ms() sleeps until the timeout or any interrupt (e.g USB resume).
+ * With CFG_SUSPEND_DEEP_SLEEP the sleep is a deep sleep in which only the timer
+ * and the USB controller keep their clocks, core 1 must be idle for it to apply.
+ */
+
+typedef enum
+{
+  POWER_IDLE = 0, // only blinking and polling
+  POWER_BUSY,     // CDC traffic or high-rate reports
+  POWER_SLEEP,    // bus suspended
+} power_demand_t;
+
+void power_init(void);
+
+// Call once per main loop iteration with the current demand
+void power_clock_update(power_demand_t demand);
+
+void power_wait_ms(uint32_t ms);
+
+// Console: clock [auto|high|low]
+void power_cmd(int argc, char* argv[]);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,152 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "hardware/watchdog.h"
+#include "pico/time.h"
+
+#include "app_config.h"
+#include "app_state.h"
+#include "console.h"
+#include "crc.h"
+#include "event_log.h"
+#include "motion.h"
+#include "recovery.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+// Changes with the snapshot layout, so a snapshot of another firmware is never restored
+#define SNAPSHOT_MAGIC    (0x57410000u | (uint16_t) sizeof(warm_state_t))
+
+typedef struct
+{
+  uint32_t seq;                // snapshots taken since cold boot
+  uint32_t warm_boots;         // watchdog resets recovered from
+  uint32_t streak;             // of those, in a row without CFG_RECOVERY_CLEAN_MS of clean run
+  app_state_t app;
+  uint32_t motion_count;
+  motion_step_t motion[CFG_POOL_MACROS];
+} warm_state_t;
+
+// Survives a watchdog reset: not cleared by the runtime start-up code
+static warm_state_t __uninitialized_ram(warm_state);
+
+static bool warm_boot;
+static uint32_t snapshot_ms;
+static uint32_t start_ms;
+
+static uint32_t snapshot_crc(void)
+{
+  return crc32_update(0, &warm_state, sizeof(warm_state));
+}
+
+static void take_snapshot(void)
+{
+  warm_state.seq++;
+  app_state_snapshot(&warm_state.app);
+  warm_state.motion_count = motion_snapshot(warm_state.motion, CFG_POOL_MACROS);
+
+  // invalidate first so a reset in the middle of the update is not taken for a valid snapshot
+  watchdog_hw->scratch[0] = 0;
+  watchdog_hw->scratch[1] = snapshot_crc();
+  watchdog_hw->scratch[0] = SNAPSHOT_MAGIC;
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void recovery_init(void)
+{
+  bool const valid = watchdog_enable_caused_reboot() && watchdog_hw->scratch[0] == SNAPSHOT_MAGIC &&
+                     watchdog_hw->scratch[1] == snapshot_crc();
+
+  // restoring the same state over and over would only hang again: give up and cold boot
+  bool const gave_up = valid && warm_state.streak >= CFG_RECOVERY_MAX_WARM;
+  warm_boot = valid && !gave_up;
+
+  if ( warm_boot )
+  {
+    warm_state.warm_boots++;
+    warm_state.streak++;
+    app_state_restore(&warm_state.app);
+    motion_restore(warm_state.motion, warm_state.motion_count);
+  }else
+  {
+    memset(&warm_state, 0, sizeof(warm_state));
+  }
+
+  uint8_t const flags = (watchdog_enable_caused_reboot() ? LOG_BOOT_WATCHDOG : 0) | (warm_boot ? LOG_BOOT_WARM : 0) |
+                        (gave_up ? LOG_BOOT_GAVE_UP : 0);
+  event_log(LOG_EV_BOOT, flags, warm_state.warm_boots);
+
+  take_snapshot();
+}
+
+void recovery_start(void)
+{
+  // pause on debug so a breakpoint does not reset the chip
+  watchdog_enable(CFG_WATCHDOG_MS, true);
+  snapshot_ms = start_ms = to_ms_since_boot(get_absolute_time());
+}
+
+void recovery_task(void)
+{
+  watchdog_update();
+
+  uint32_t const now = to_ms_since_boot(get_absolute_time());
+  if ( now - snapshot_ms < CFG_SNAPSHOT_MS ) return;
+  snapshot_ms = now;
+
+  // ran long enough after the restart: the next hang is a new one, saved with this snapshot
+  if ( warm_state.streak && now - start_ms >= CFG_RECOVERY_CLEAN_MS ) warm_state.streak = 0;
+
+  take_snapshot();
+}
+
+bool recovery_warm_boot(void)
+{
+  return warm_boot;
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void recovery_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 && !strcmp(argv[1], "hang") )
+  {
+    // simulate a main loop hang
+    while ( 1 ) { }
+  }
+
+  console_printf("%s boot, %lu warm restarts (%lu in a row, cold boot after %u), snapshot #%lu, %lu motion macros saved\r\n",
+                 warm_boot ? "warm" : "cold", (unsigned long) warm_state.warm_boots, (unsigned long) warm_state.streak,
+                 CFG_RECOVERY_MAX_WARM, (unsigned long) warm_state.seq, (unsigned long) warm_state.motion_count);
+}
@@ -0,0 +1,61 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef RECOVERY_H_
+#define RECOVERY_H_
+
+#include <stdbool.h>
+
+/* Watchdog supervision and warm restart.
+ *
+ * The main loop feeds the watchdog through recovery_task(), so a hang resets the
+ * chip after CFG_WATCHDOG_MS. Every CFG_SNAPSHOT_MS the same call stores a
+ * snapshot of the application state (LED and HID state blocks, queued motion
+ * macros, counters) in RAM that the boot code does not clear, with its CRC in
+ * watchdog scratch registers 0 and 1 (2..3 are spare, 4..7 belong to the SDK).
+ * After a watchdog reset recovery_init() validates the snapshot and restores
+ * it, so the device carries on where it stopped once the host has enumerated it
+ * again. Any other reset is a cold boot. So is the CFG_RECOVERY_MAX_WARM-th
+ * watchdog reset in a row without CFG_RECOVERY_CLEAN_MS of main loop run in
+ * between: the restored state is then the likely cause, and restoring it again
+ * would boot-loop. The event log marks that boot with LOG_BOOT_GAVE_UP.
+ */
+
+// Restore a valid snapshot after a watchdog reset, call after all modules are initialised
+void recovery_init(void);
+
+// Start the watchdog, call right before the main loop
+void recovery_start(void);
+
+// Feed the watchdog and refresh the snapshot, call once per main loop iteration
+void recovery_task(void);
+
+// True if this boot restored a snapshot
+bool recovery_warm_boot(void);
+
+// Console: wdt [hang]
+void recovery_cmd(int argc, char* argv[]);
+
+#endif /* RECOVERY_H_ */
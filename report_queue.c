@@ -0,0 +1,189 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "hardware/timer.h"
+
+#include "app_config.h"
+#include "app_state.h"
+#include "perf.h"
+#include "pool.h"
+#include "report_queue.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+// only core 0 produces and sends reports
+POOL_DEFINE_IN(report_pool, queued_report_t, CFG_POOL_REPORTS, __core0_data("report_queue"));
+
+typedef struct
+{
+  queued_report_t* head;
+  queued_report_t* tail;
+} report_list_t;
+
+static report_list_t __core0_data("report_queue") queues[REPORT_PRIO_COUNT];
+
+#if CFG_CORE_SRAM_PLACEMENT
+// All of __core0_data(): the state blocks in main.c, the report pool and the queues.
+// A larger CFG_POOL_REPORTS would eat into the core 0 stack beside them.
+TU_VERIFY_STATIC(sizeof(led_state_t) + sizeof(hid_state_t) + sizeof(report_pool_storage) + sizeof(report_pool_links) +
+                 sizeof(report_pool) + sizeof(queues) <= CFG_CORE0_DATA_MAX, "core 0 data exceeds CFG_CORE0_DATA_MAX in SCRATCH_Y");
+#endif
+
+// Queue time of the report in flight on each interface, for latency statistics
+static uint32_t in_flight_us[CFG_TUD_HID];
+static bool in_flight[CFG_TUD_HID];
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void report_queue_init(void)
+{
+  pool_register(&report_pool);
+}
+
+queued_report_t* __hot_path_func(report_queue_alloc)(void)
+{
+  queued_report_t* report = report_pool_acquire();
+  if ( report ) report->next = NULL;
+  return report;
+}
+
+void __hot_path_func(report_queue_push)(queued_report_t* report, report_prio_t prio)
+{
+  report_list_t* q = &queues[prio];
+
+  report->next = NULL;
+  report->queued_us = time_us_32();
+  if ( q->tail ) q->tail->next = report;
+  else q->head = report;
+  q->tail = report;
+}
+
+bool __hot_path_func(report_queue_service)(void)
+{
+  for ( int prio = REPORT_PRIO_COUNT - 1; prio >= 0; prio-- )
+  {
+    report_list_t* q = &queues[prio];
+    queued_report_t* prev = NULL;
+
+    // oldest report whose endpoint is free, reports of a busy interface keep their order
+    for ( queued_report_t* r = q->head; r; prev = r, r = r->next )
+    {
+      if ( !tud_hid_n_ready(r->instance) ) continue;
+
+      if ( !tud_hid_n_report(r->instance, r->report_id, r->data, r->len) ) return false;
+
+      if ( prev ) prev->next = r->next;
+      else q->head = r->next;
+      if ( q->tail == r ) q->tail = prev;
+
+      in_flight_us[r->instance] = r->queued_us;
+      in_flight[r->instance] = true;
+
+      report_pool_release(r);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void __hot_path_func(report_queue_complete)(uint8_t instance)
+{
+  // reports sent directly with tud_hid_report() are not timed
+  if ( instance >= CFG_TUD_HID || !in_flight[instance] ) return;
+
+  in_flight[instance] = false;
+  perf_report_done(time_us_32() - in_flight_us[instance]);
+}
+
+void report_queue_abort(void)
+{
+  for ( int i = 0; i < CFG_TUD_HID; i++ ) in_flight[i] = false;
+}
+
+// Remove the reports matching instance (all of them if instance is negative)
+static uint32_t drop_reports(int instance)
+{
+  uint32_t count = 0;
+
+  for ( int prio = 0; prio < REPORT_PRIO_COUNT; prio++ )
+  {
+    report_list_t* q = &queues[prio];
+    queued_report_t* prev = NULL;
+    queued_report_t* r = q->head;
+
+    while ( r )
+    {
+      queued_report_t* next = r->next;
+
+      if ( instance < 0 || r->instance == instance )
+      {
+        if ( prev ) prev->next = next;
+        else q->head = next;
+        if ( q->tail == r ) q->tail = prev;
+
+        report_pool_release(r);
+        count++;
+      }else
+      {
+        prev = r;
+      }
+
+      r = next;
+    }
+  }
+
+  return count;
+}
+
+uint32_t report_queue_flush(void)
+{
+  report_queue_abort();
+  return drop_reports(-1);
+}
+
+uint32_t report_queue_drop_instance(uint8_t instance)
+{
+  return drop_reports(instance);
+}
+
+uint32_t __hot_path_func(report_queue_pending)(uint8_t instance)
+{
+  uint32_t count = 0;
+
+  for ( int prio = 0; prio < REPORT_PRIO_COUNT; prio++ )
+  {
+    for ( queued_report_t const* r = queues[prio].head; r; r = r->next )
+    {
+      if ( r->instance == instance ) count++;
+    }
+  }
+
+  return count;
+}
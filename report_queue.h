@@ -0,0 +1,78 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef REPORT_QUEUE_H_
+#define REPORT_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tusb.h"
+
+// HID report waiting for its endpoint, allocated from the report pool
+typedef struct queued_report
+{
+  struct queued_report* next;
+  uint8_t instance;
+  uint8_t report_id;
+  uint8_t len;
+  uint32_t queued_us;     // set by report_queue_push()
+  uint8_t data[CFG_TUD_HID_EP_BUFSIZE];
+} queued_report_t;
+
+typedef enum
+{
+  REPORT_PRIO_NORMAL = 0,
+  REPORT_PRIO_HIGH,       // sent before any normal report
+  REPORT_PRIO_COUNT
+} report_prio_t;
+
+void report_queue_init(void);
+
+// Get an empty report from the pool, NULL if the pool is exhausted
+queued_report_t* report_queue_alloc(void);
+
+// Append report to the queue of the given priority, takes ownership
+void report_queue_push(queued_report_t* report, report_prio_t prio);
+
+// Send the oldest highest-priority report whose interface is ready, return true if one was sent
+bool report_queue_service(void);
+
+// Transfer on an interface completed, call from tud_hid_report_complete_cb()
+void report_queue_complete(uint8_t instance);
+
+// Bus reset or disconnect: transfers in flight are lost, queued reports are kept
+void report_queue_abort(void);
+
+// Drop every queued report, return how many were dropped
+uint32_t report_queue_flush(void);
+
+// Drop the queued reports of one interface, return how many were dropped
+uint32_t report_queue_drop_instance(uint8_t instance);
+
+// Number of reports queued for an instance (all priorities)
+uint32_t report_queue_pending(uint8_t instance);
+
+#endif /* REPORT_QUEUE_H_ */
@@ -0,0 +1,132 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "tusb.h"
+
+#include "app_config.h"
+#include "console.h"
+#include "motion.h"
+#include "report_queue.h"
+#include "reset_policy.h"
+#include "usb_descriptors.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+enum
+{
+  WORK_REPORTS = 0,
+  WORK_MOTION,
+  WORK_COMMANDS,
+  WORK_COUNT
+};
+
+static char const* const work_names[WORK_COUNT] = { "reports", "motion", "commands" };
+static char const* const action_names[] = { "keep", "flush" };
+
+static reset_action_t policy[WORK_COUNT] =
+{
+  [WORK_REPORTS]  = CFG_RESET_KEEP_REPORTS  ? RESET_KEEP : RESET_FLUSH,
+  [WORK_MOTION]   = CFG_RESET_KEEP_MOTION   ? RESET_KEEP : RESET_FLUSH,
+  [WORK_COMMANDS] = CFG_RESET_KEEP_COMMANDS ? RESET_KEEP : RESET_FLUSH,
+};
+
+static uint32_t resets;
+static uint32_t flushed[WORK_COUNT];
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void reset_policy_init(void)
+{
+  tud_cdc_configure_fifo_t const cfg = { .rx_persistent = 1, .tx_persistent = 1 };
+  tud_cdc_configure_fifo(&cfg);
+}
+
+void reset_policy_disconnected(void)
+{
+  resets++;
+
+  report_queue_abort();
+  if ( policy[WORK_REPORTS] == RESET_FLUSH ) flushed[WORK_REPORTS] += report_queue_flush();
+  if ( policy[WORK_MOTION] == RESET_FLUSH ) flushed[WORK_MOTION] += motion_stop_all();
+  if ( policy[WORK_COMMANDS] == RESET_FLUSH ) flushed[WORK_COMMANDS] += console_flush();
+}
+
+void reset_policy_connected(uint8_t config)
+{
+  // the high resolution interface only exists in the high-rate configuration
+  if ( config != CONFIG_HIGH_RATE ) flushed[WORK_REPORTS] += report_queue_drop_instance(HID_INSTANCE_HIRES);
+
+  if ( policy[WORK_COMMANDS] == RESET_FLUSH )
+  {
+    tud_cdc_read_flush();
+    tud_cdc_write_clear();
+  }
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+static int find(char const* const* names, int count, char const* name)
+{
+  for ( int i = 0; i < count; i++ )
+  {
+    if ( !strcmp(names[i], name) ) return i;
+  }
+  return -1;
+}
+
+void reset_policy_cmd(int argc, char* argv[])
+{
+  if ( argc == 3 )
+  {
+    int const work = strcmp(argv[1], "all") ? find(work_names, WORK_COUNT, argv[1]) : WORK_COUNT;
+    int const action = find(action_names, TU_ARRAY_SIZE(action_names), argv[2]);
+
+    if ( work < 0 || action < 0 )
+    {
+      console_printf("usage: policy [reports|motion|commands|all keep|flush]\r\n");
+      return;
+    }
+
+    for ( int i = 0; i < WORK_COUNT; i++ )
+    {
+      if ( work == WORK_COUNT || work == i ) policy[i] = (reset_action_t) action;
+    }
+    return;
+  }
+
+  console_printf("%lu resets/disconnects\r\n", (unsigned long) resets);
+  for ( int i = 0; i < WORK_COUNT; i++ )
+  {
+    console_printf("%-8s %-5s %lu flushed\r\n", work_names[i], action_names[policy[i]], (unsigned long) flushed[i]);
+  }
+}
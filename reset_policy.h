@@ -0,0 +1,60 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef RESET_POLICY_H_
+#define RESET_POLICY_H_
+
+#include <stdint.h>
+
+/* What survives a USB bus reset or a disconnect.
+ *
+ * For each kind of in-progress work the policy either keeps it, to resume once
+ * the host has configured the device again, or flushes it:
+ * - reports  : queued HID reports (the transfer in flight is always lost)
+ * - motion   : running and queued motion macros
+ * - commands : CDC command lines not yet run, plus the CDC FIFO contents
+ *
+ * Kept reports for an interface the new configuration does not have are dropped.
+ */
+
+typedef enum
+{
+  RESET_KEEP = 0,
+  RESET_FLUSH,
+} reset_action_t;
+
+// Call before tud_init(), makes the CDC FIFOs survive a reset so the policy decides
+void reset_policy_init(void);
+
+// Device lost its configuration: bus reset or unplug
+void reset_policy_disconnected(void);
+
+// Device configured again, 'config' is the CONFIG_* index selected by the host
+void reset_policy_connected(uint8_t config);
+
+// Console: policy [reports|motion|commands|all keep|flush]
+void reset_policy_cmd(int argc, char* argv[]);
+
+#endif /* RESET_POLICY_H_ */
@@ -0,0 +1,236 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "bsp/board_api.h"
+#include "hardware/structs/usb.h"
+#include "hardware/timer.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "binlog.h"
+#include "console.h"
+#include "sof_clock.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define SOF_LOST_US       3000      // no frame for this long: the bus stopped, as the suspend detection
+#define SOF_WRAP_US       2000000   // the frame number wraps every 2048 frames, a longer gap loses count
+#define SOF_EDGE_FRAMES   64        // frames at the start of a window searched for the edge
+
+TU_VERIFY_STATIC(CFG_SOF_DRIFT_FRAMES > 2 * SOF_EDGE_FRAMES, "drift window shorter than its edge search");
+
+static struct
+{
+  bool locked;
+  uint32_t sof;            // frame number at the last sample
+  uint32_t frames;         // extended frame count
+  uint32_t frame_us;       // device time the frame number last changed
+  uint32_t offset_ms;      // sof_clock_ms() minus frames (locked) or board_millis()
+
+  // phase reference, set at lock
+  uint32_t ref_us;
+  uint32_t ref_frames;
+
+  // edge of the current window and the previous one
+  uint32_t window_frames;  // frame count at the start of the window
+  bool     searching;      // within the first SOF_EDGE_FRAMES of the window
+  bool     edge_valid;
+  int32_t  edge_phase;
+  uint32_t edge_frames;
+  bool     prev_valid;
+  int32_t  prev_phase;
+  uint32_t prev_frames;
+} clk;
+
+static struct
+{
+  uint32_t locks;
+  uint32_t lost;           // frames stopped while mounted: a bus reset, or a suspend not detected yet
+  uint32_t windows;        // drift measurements
+  int32_t drift_ppb;       // last one
+  int32_t min_ppb;
+  int32_t max_ppb;
+} stats;
+
+//--------------------------------------------------------------------+
+// Lock and drift
+//--------------------------------------------------------------------+
+
+static void lock(uint32_t now_us)
+{
+  // carry the crystal clock over into the frame count
+  clk.offset_ms = board_millis() + clk.offset_ms - clk.frames;
+  clk.locked = true;
+
+  clk.ref_us = now_us;
+  clk.ref_frames = clk.frames;
+  clk.window_frames = clk.frames;
+  clk.searching = true;
+  clk.edge_valid = false;
+  clk.prev_valid = false;
+  stats.locks++;
+}
+
+static void unlock(void)
+{
+  clk.offset_ms = clk.frames + clk.offset_ms - board_millis();
+  clk.locked = false;
+}
+
+static void measure(void)
+{
+  int64_t const ppb = (int64_t) (clk.edge_phase - clk.prev_phase) * 1000000 / (int32_t) (clk.edge_frames - clk.prev_frames);
+  int32_t const drift = (int32_t) ((ppb > INT32_MAX) ? INT32_MAX : (ppb < INT32_MIN) ? INT32_MIN : ppb);
+
+  if ( !stats.windows || drift < stats.min_ppb ) stats.min_ppb = drift;
+  if ( !stats.windows || drift > stats.max_ppb ) stats.max_ppb = drift;
+  stats.drift_ppb = drift;
+  stats.windows++;
+
+  BINLOG("sof drift %d ppb over %u frames", drift, clk.edge_frames - clk.prev_frames);
+}
+
+// A new frame number seen at now_us while locked
+static void __hot_path_func(sample)(uint32_t now_us)
+{
+  if ( clk.frames - clk.window_frames >= CFG_SOF_DRIFT_FRAMES )
+  {
+    clk.window_frames = clk.frames;
+    clk.searching = true;
+    clk.edge_valid = false;
+  }
+  if ( !clk.searching ) return;
+
+  // modulo 2^32 on both sides, correct while the phase stays within +-35 minutes
+  int32_t const phase = (int32_t) ((now_us - clk.ref_us) - (clk.frames - clk.ref_frames) * 1000u);
+
+  if ( !clk.edge_valid || phase < clk.edge_phase )
+  {
+    clk.edge_phase = phase;
+    clk.edge_frames = clk.frames;
+    clk.edge_valid = true;
+  }
+
+  if ( clk.frames - clk.window_frames < SOF_EDGE_FRAMES ) return;
+
+  // edge found, compare it with the previous window's
+  clk.searching = false;
+  if ( clk.prev_valid ) measure();
+  clk.prev_valid = true;
+  clk.prev_phase = clk.edge_phase;
+  clk.prev_frames = clk.edge_frames;
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void __hot_path_func(sof_clock_task)(void)
+{
+  uint32_t const now_us = time_us_32();
+  uint32_t const sof = usb_hw->sof_rd & USB_SOF_RD_BITS;
+  bool const bus_up = tud_mounted() && !tud_suspended();
+
+  if ( sof != clk.sof )
+  {
+    uint32_t const gap_us = now_us - clk.frame_us;
+
+    clk.frames += (sof - clk.sof) & USB_SOF_RD_BITS;
+    clk.sof = sof;
+    clk.frame_us = now_us;
+
+    if ( clk.locked && gap_us >= SOF_WRAP_US )
+    {
+      unlock();
+      stats.lost++;
+    }
+
+    if ( clk.locked ) sample(now_us);
+    else if ( bus_up ) lock(now_us);
+  }else if ( clk.locked && now_us - clk.frame_us >= SOF_LOST_US && bus_up )
+  {
+    unlock();
+    stats.lost++;
+  }
+
+  if ( clk.locked && !bus_up ) unlock();
+}
+
+uint32_t __hot_path_func(sof_clock_ms)(void)
+{
+  return (clk.locked ? clk.frames : board_millis()) + clk.offset_ms;
+}
+
+bool sof_clock_locked(void)
+{
+  return clk.locked;
+}
+
+bool sof_clock_drift(int32_t* ppb)
+{
+  if ( !stats.windows ) return false;
+  *ppb = stats.drift_ppb;
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+// ppb as signed ppm with three decimals
+static void print_ppm(char const* label, int32_t ppb)
+{
+  uint32_t const abs_ppb = (ppb < 0) ? (uint32_t) -(int64_t) ppb : (uint32_t) ppb;
+  console_printf("%s%c%lu.%03lu ppm", label, (ppb < 0) ? '-' : '+', (unsigned long) (abs_ppb / 1000),
+                 (unsigned long) (abs_ppb % 1000));
+}
+
+void sof_clock_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 && !strcmp(argv[1], "reset") )
+  {
+    memset(&stats, 0, sizeof(stats));
+    return;
+  }
+
+  console_printf("%s, frame %lu, clock %lu ms, board %lu ms\r\n", clk.locked ? "locked" : "free running",
+                 (unsigned long) clk.frames, (unsigned long) sof_clock_ms(), (unsigned long) board_millis());
+  console_printf("%lu locks, %lu lost\r\n", (unsigned long) stats.locks, (unsigned long) stats.lost);
+
+  if ( !stats.windows )
+  {
+    console_printf("drift not measured yet, takes %u frames locked\r\n", CFG_SOF_DRIFT_FRAMES + SOF_EDGE_FRAMES);
+    return;
+  }
+
+  print_ppm("drift ", stats.drift_ppb);
+  print_ppm(" (min ", stats.min_ppb);
+  print_ppm(", max ", stats.max_ppb);
+  console_printf(") over %lu windows of %u frames\r\n", (unsigned long) stats.windows, CFG_SOF_DRIFT_FRAMES);
+}
@@ -0,0 +1,70 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef SOF_CLOCK_H_
+#define SOF_CLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Millisecond timebase disciplined to the host's USB frame clock.
+ *
+ * board_millis() counts the device crystal, the host polls on its own 1 kHz
+ * frame clock. A few tens of ppm apart, a 1 ms report tick slowly slides
+ * against the polls: every so often two reports meet one poll, or a poll finds
+ * nothing. Reports paced by sof_clock_ms() are phase locked to the polls.
+ *
+ * The frame number (SOF_RD, 11 bits) is read once per main loop iteration,
+ * like usb_stats, and extended to 32 bits; both sof_clock_task() and
+ * sof_clock_ms() are __hot_path_func. While the bus runs, sof_clock_ms()
+ * counts frames; otherwise (unmounted, suspended, no frame for SOF_LOST_US) it
+ * counts board_millis(). Each switch carries the value over, so the clock
+ * never jumps. The SOF interrupt (tud_sof_cb) is not used: it would wake the
+ * CPU every frame, and TinyUSB delivers it from tud_task(), no closer to the
+ * frame edge than the main loop.
+ *
+ * Drift: the loop sees a frame at or after its start, never before, so the
+ * lowest phase (device us - 1000 * frames) seen over the first 64 frames of
+ * a window marks the frame edge on the device clock.
+ * The edge moving between two windows CFG_SOF_DRIFT_FRAMES apart is the drift,
+ * positive when the crystal runs fast. Each lock starts the windows over.
+ */
+
+// Sample the frame number, call once per main loop iteration, right after tud_task()
+void sof_clock_task(void);
+
+// Milliseconds on the frame clock while locked, on the crystal otherwise, as of the last sof_clock_task()
+uint32_t sof_clock_ms(void);
+
+// Counting frames
+bool sof_clock_locked(void);
+
+// Last measured drift of the crystal against the frame clock in ppb (ppm * 1000), false if none yet
+bool sof_clock_drift(int32_t* ppb);
+
+// Console: sof [reset]
+void sof_clock_cmd(int argc, char* argv[]);
+
+#endif /* SOF_CLOCK_H_ */
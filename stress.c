@@ -0,0 +1,216 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "hardware/timer.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "binlog.h"
+#include "console.h"
+#include "hid_reports.h"
+#include "report_queue.h"
+#include "stress.h"
+#include "usb_descriptors.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  uint32_t queued;
+  uint32_t completed;
+  uint32_t gaps;          // completions later than 1.5 polling intervals
+  uint32_t max_gap_us;    // longest time between two completions
+  uint32_t alloc_failed;  // report pool empty
+  uint32_t last_us;       // previous completion, 0: none to measure from
+  uint16_t seq;           // next sequence number
+} stress_stat_t;
+
+static bool running;
+static uint32_t start_us;
+static uint32_t poll_us;    // polling interval of the active configuration
+static uint32_t rng = 1;
+static int16_t undo_x[CFG_TUD_HID], undo_y[CFG_TUD_HID];
+static stress_stat_t stats[CFG_TUD_HID];
+
+static void stats_reset(void)
+{
+  memset(stats, 0, sizeof(stats));
+  start_us = time_us_32();
+}
+
+// xorshift32
+static inline uint32_t next_random(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+// Random delta in -range..range, or the one undoing the previous report
+static inline void next_delta(uint8_t instance, int32_t range, int16_t* dx, int16_t* dy)
+{
+  stress_stat_t const* s = &stats[instance];
+
+  if ( s->queued & 1 )
+  {
+    *dx = (int16_t) -undo_x[instance];
+    *dy = (int16_t) -undo_y[instance];
+  }else
+  {
+    uint32_t const r = next_random();
+    *dx = (int16_t) ((int32_t) ((r & 0xFFFF) % (2 * range + 1)) - range);
+    *dy = (int16_t) ((int32_t) ((r >> 16) % (2 * range + 1)) - range);
+    undo_x[instance] = *dx;
+    undo_y[instance] = *dy;
+  }
+}
+
+static bool __hot_path_func(queue_stress_report)(uint8_t instance)
+{
+  stress_stat_t* s = &stats[instance];
+
+  queued_report_t* r = report_queue_alloc();
+  if ( !r )
+  {
+    s->alloc_failed++;
+    return false;
+  }
+
+  int16_t dx, dy;
+  r->instance = instance;
+
+  if ( instance == HID_INSTANCE_HIRES )
+  {
+    next_delta(instance, 2047, &dx, &dy);
+    hires_mouse_report_t const report = { .buttons = 0, .x = dx, .y = dy, .wheel = 0, .pan = 0, .seq = s->seq };
+    r->report_id = REPORT_ID_HIRES_MOUSE;
+    r->len = (uint8_t) hid_pack_hires_mouse(r->data, &report);
+  }else
+  {
+    next_delta(instance, 127, &dx, &dy);
+    mouse_report_t const report = { .buttons = 0, .x = (int8_t) dx, .y = (int8_t) dy, .wheel = 0, .pan = 0, .seq = s->seq };
+    r->report_id = REPORT_ID_MOUSE;
+    r->len = (uint8_t) hid_pack_mouse(r->data, &report);
+  }
+
+  report_queue_push(r, REPORT_PRIO_NORMAL);
+  s->seq++;
+  s->queued++;
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+bool stress_active(void)
+{
+  return running;
+}
+
+void __hot_path_func(stress_task)(uint8_t instances, uint32_t interval_us)
+{
+  if ( !tud_mounted() ) return;
+
+  poll_us = interval_us;
+
+  // one report waiting behind the one in the endpoint: every poll finds data
+  for ( uint8_t i = 0; i < instances && i < CFG_TUD_HID; i++ )
+  {
+    if ( !report_queue_pending(i) ) queue_stress_report(i);
+  }
+}
+
+void __hot_path_func(stress_complete)(uint8_t instance)
+{
+  if ( !running || instance >= CFG_TUD_HID ) return;
+
+  stress_stat_t* s = &stats[instance];
+  uint32_t const now = time_us_32();
+
+  if ( s->last_us )
+  {
+    uint32_t const gap = now - s->last_us;
+    if ( gap > s->max_gap_us ) s->max_gap_us = gap;
+    if ( gap > poll_us + poll_us / 2 ) s->gaps++;
+  }
+
+  s->last_us = now ? now : 1;
+  s->completed++;
+}
+
+void stress_pause(void)
+{
+  for ( int i = 0; i < CFG_TUD_HID; i++ ) stats[i].last_us = 0;
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void stress_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 )
+  {
+    if ( !strcmp(argv[1], "start") )
+    {
+      stats_reset();
+      running = true;
+      BINLOG("stress started");
+    }else if ( !strcmp(argv[1], "stop") )
+    {
+      running = false;
+      BINLOG("stress stopped");
+    }else if ( !strcmp(argv[1], "reset") )
+    {
+      stats_reset();
+    }else
+    {
+      console_printf("usage: stress [start|stop|reset]\r\n");
+    }
+    return;
+  }
+
+  uint32_t const elapsed_us = time_us_32() - start_us;
+  console_printf("%s, %lu ms, polled every %lu us\r\n", running ? "running" : "stopped",
+                 (unsigned long) (elapsed_us / 1000), (unsigned long) poll_us);
+
+  for ( int i = 0; i < CFG_TUD_HID; i++ )
+  {
+    stress_stat_t const* s = &stats[i];
+    if ( !s->queued ) continue;
+
+    // completions per second, against the 1e6 / poll_us the host should reach
+    uint32_t const rate = elapsed_us ? (uint32_t) ((uint64_t) s->completed * 1000000u / elapsed_us) : 0;
+    console_printf("hid%d %lu queued, %lu done, %lu/s, %lu gaps, max gap %lu us, %lu pool empty\r\n", i,
+                   (unsigned long) s->queued, (unsigned long) s->completed, (unsigned long) rate,
+                   (unsigned long) s->gaps, (unsigned long) s->max_gap_us, (unsigned long) s->alloc_failed);
+  }
+}
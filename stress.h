@@ -0,0 +1,63 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef STRESS_H_
+#define STRESS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum rate HID traffic, for qualifying hosts and hubs.
+ *
+ * "stress start" replaces the demo motion: every HID interface of the active
+ * configuration always has a report queued, so each poll of its endpoint finds
+ * data. Reports move the pointer by pseudo random amounts, every second report
+ * takes the previous one back, so the pointer stays put (pointer acceleration
+ * on the host may still let it wander). Buttons, wheel and pan stay 0.
+ *
+ * Each report carries a per interface sequence number in its vendor defined
+ * "seq" field, so a host side reader can count lost or repeated reports.
+ * The device counts what it can see itself: completions per second against
+ * the endpoint's polling rate, and gaps, completions more than 1.5 polling
+ * intervals after the previous one. A gap is a poll that returned no data or
+ * did not happen. "usb" (usb_stats.h) tells the two apart through the NAKs on
+ * the endpoint.
+ */
+
+bool stress_active(void);
+
+// Keep a report queued on HID instances 0 .. instances-1, whose endpoints are polled every interval_us
+void stress_task(uint8_t instances, uint32_t interval_us);
+
+// A report of instance completed, call from tud_hid_report_complete_cb()
+void stress_complete(uint8_t instance);
+
+// No completions are expected for a while (suspend, bus reset), do not count it as a gap
+void stress_pause(void);
+
+// Console: stress [start|stop|reset]
+void stress_cmd(int argc, char* argv[]);
+
+#endif /* STRESS_H_ */
@@ -0,0 +1,197 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/* Render the records of the firmware's binary log (binlog.h).
+ *
+ *   binlog_decode firmware.elf [capture.txt]
+ *
+ * Reads a capture of "binlog dump" / "binlog follow" console output (stdin by
+ * default). Every line starting with '~' is a record: hex words holding
+ * id << 8 | argument count, the timestamp in us, and the raw arguments. The id
+ * is the offset of the format string in the .logfmt section of the ELF the
+ * firmware was built from; other lines are ignored. Output is one line per
+ * record, the timestamp in seconds followed by the formatted message.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elf_file.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+// Must match binlog.h
+#define BINLOG_ID_SHIFT   8
+#define BINLOG_MAX_ARGS   4
+
+//--------------------------------------------------------------------+
+// Formatting
+//--------------------------------------------------------------------+
+
+// printf() with 32-bit integer arguments only: each conversion is handed to the C
+// library with its flags and width, length modifiers are dropped
+static void render(char const* fmt, uint32_t const* args, unsigned count)
+{
+  unsigned used = 0;
+
+  for ( char const* p = fmt; *p; p++ )
+  {
+    if ( *p != '%' )
+    {
+      putchar(*p);
+      continue;
+    }
+
+    if ( p[1] == '%' )
+    {
+      putchar('%');
+      p++;
+      continue;
+    }
+
+    char spec[32] = "%";
+    size_t len = 1;
+
+    p++;
+    while ( *p && strchr("-+ #0123456789.", *p) && len < sizeof(spec) - 3 ) spec[len++] = *p++;
+    while ( *p && strchr("hlLjzt", *p) ) p++;
+    if ( !*p ) break;
+
+    char const conv = *p;
+    if ( !strchr("diuxXoc", conv) && conv != 'p' )
+    {
+      printf("<%%%c?>", conv);
+      continue;
+    }
+
+    if ( used >= count )
+    {
+      printf("<missing>");
+      continue;
+    }
+
+    uint32_t const arg = args[used++];
+    if ( conv == 'p' )
+    {
+      printf("0x%08x", (unsigned) arg);
+      continue;
+    }
+
+    spec[len++] = conv;
+    spec[len] = 0;
+    if ( conv == 'd' || conv == 'i' ) printf(spec, (int) (int32_t) arg);
+    else printf(spec, (unsigned) arg);
+  }
+
+  putchar('\n');
+}
+
+static bool decode_line(char const* line, uint8_t const* strings, size_t strings_size)
+{
+  uint32_t words[2 + BINLOG_MAX_ARGS];
+  unsigned count = 0;
+
+  while ( isspace((unsigned char) *line) ) line++;
+  if ( *line++ != '~' ) return false;
+
+  while ( count < 2 + BINLOG_MAX_ARGS )
+  {
+    char* end;
+    unsigned long w = strtoul(line, &end, 16);
+    if ( end == line ) break;
+    words[count++] = (uint32_t) w;
+    line = end;
+  }
+
+  if ( count < 2 ) return false;
+
+  uint32_t const id = words[0] >> BINLOG_ID_SHIFT;
+  unsigned const nargs = words[0] & 0xFFu;
+
+  printf("%12.6f ", words[1] / 1e6);
+
+  if ( id >= strings_size || !memchr(strings + id, 0, strings_size - id) )
+  {
+    printf("<unknown id 0x%x, ELF does not match the firmware?>\n", (unsigned) id);
+    return true;
+  }
+
+  render((char const*) strings + id, words + 2, nargs < count - 2 ? nargs : count - 2);
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Main
+//--------------------------------------------------------------------+
+
+int main(int argc, char* argv[])
+{
+  if ( argc < 2 || argc > 3 )
+  {
+    fprintf(stderr, "usage: binlog_decode firmware.elf [capture.txt]\n");
+    return 2;
+  }
+
+  elf_file_t elf;
+  if ( !elf_open(&elf, argv[1]) )
+  {
+    fprintf(stderr, "binlog_decode: cannot read ELF '%s'\n", argv[1]);
+    return 1;
+  }
+
+  size_t strings_size;
+  uint8_t const* strings = elf_find_section(&elf, ".logfmt", &strings_size);
+  if ( !strings )
+  {
+    fprintf(stderr, "binlog_decode: '%s' has no .logfmt section\n", argv[1]);
+    elf_close(&elf);
+    return 1;
+  }
+
+  FILE* in = (argc == 3) ? fopen(argv[2], "r") : stdin;
+  if ( !in )
+  {
+    fprintf(stderr, "binlog_decode: cannot open '%s'\n", argv[2]);
+    elf_close(&elf);
+    return 1;
+  }
+
+  char line[256];
+  unsigned records = 0;
+  while ( fgets(line, sizeof(line), in) )
+  {
+    if ( decode_line(line, strings, strings_size) ) records++;
+  }
+
+  if ( in != stdin ) fclose(in);
+  elf_close(&elf);
+
+  fprintf(stderr, "%u records\n", records);
+  return 0;
+}
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2026 pico-mouse contributors
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+"""Send a firmware image to the device over its CDC console and install it.
+
+    tools/cdc_update.py /dev/ttyACM0 build/dev_hid_composite.bin build/dev_hid_composite_b.bin [--no-commit]
+
+Uses the "update" console command (see update.h). The device runs from slot A or
+B and takes the image linked for the other one: pass both builds and the one
+whose reset vector points into the free slot is sent. Only the Python standard
+library is needed; the port is put in raw mode with termios (Linux, macOS).
+"""
+
+import argparse
+import os
+import re
+import select
+import struct
+import sys
+import termios
+import time
+import tty
+import zlib
+
+
+def read_until(fd, patterns, timeout):
+    """Read console output until a line contains one of patterns, return that line."""
+    buf = b""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        ready, _, _ = select.select([fd], [], [], 0.1)
+        if not ready:
+            continue
+        buf += os.read(fd, 256)
+        while b"\n" in buf:
+            line, buf = buf.split(b"\n", 1)
+            text = line.decode(errors="replace").strip()
+            if any(p in text for p in patterns):
+                return text
+    sys.exit("timeout waiting for " + " or ".join(patterns))
+
+
+def command(fd, line):
+    os.write(fd, line.encode() + b"\r")
+
+
+def linked_for(image, start, size):
+    """True if the reset vector, after boot2 at the start of the image, lies in [start, start + size)."""
+    if len(image) < 0x108:
+        return False
+    reset = struct.unpack_from("<I", image, 0x104)[0]
+    return reset & 1 and 0 <= reset - (0x10000000 + start) < size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="CDC device, e.g. /dev/ttyACM0")
+    parser.add_argument("images", nargs="+", help=".bin images produced by the build, for slot A and B")
+    parser.add_argument("--no-commit", action="store_true", help="stage and verify only")
+    args = parser.parse_args()
+
+    fd = os.open(args.port, os.O_RDWR | os.O_NOCTTY)
+    try:
+        tty.setraw(fd)
+        termios.tcflush(fd, termios.TCIOFLUSH)
+
+        command(fd, "update")
+        status = read_until(fd, ["free slot"], 5)
+        free = re.search(r"free slot ([AB]) at 0x([0-9a-f]+), up to (\d+) bytes", status)
+        if not free:
+            sys.exit("unexpected reply: " + status)
+
+        image = None
+        for path in args.images:
+            with open(path, "rb") as f:
+                data = f.read()
+            if linked_for(data, int(free.group(2), 16), int(free.group(3))):
+                image = data
+                print("slot %s: %s" % (free.group(1), path))
+                break
+        if image is None:
+            sys.exit("none of the images is linked for slot " + free.group(1))
+        crc = zlib.crc32(image)
+
+        command(fd, "update begin %u %08x" % (len(image), crc))
+        # the device only erases while the bus is idle, and not while this port keeps it busy: if
+        # the free slot still holds an old image, give up and let the host suspend the device first
+        reply = read_until(fd, ["ready", "not erased", "must be", "failed"], 5)
+        if "not erased" in reply:
+            command(fd, "update abort")
+            sys.exit(reply + "\nretry after the host has suspended the device ('update' shows KB erased)")
+        if not reply.startswith("ready"):
+            sys.exit(reply)
+
+        start = time.monotonic()
+        sent = 0
+        while sent < len(image):
+            sent += os.write(fd, image[sent:])
+        reply = read_until(fd, ["verified", "failed"], 30 + len(image) // 16384)
+        elapsed = time.monotonic() - start
+        print("%s (%.1f KB/s)" % (reply, len(image) / 1024 / elapsed))
+        if "failed" in reply:
+            sys.exit(1)
+
+        if not args.no_commit:
+            command(fd, "update commit")
+            print(read_until(fd, ["rebooting", "no verified", "failed"], 5))
+    finally:
+        os.close(fd)
+
+
+if __name__ == "__main__":
+    main()
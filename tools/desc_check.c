@@ -0,0 +1,846 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+/* Decode and validate the USB descriptors compiled into the firmware image.
+ *
+ *   desc_check [-v] firmware.elf [config[:hid_report[,hid_report...]]]...
+ *
+ * Each config argument names a configuration descriptor array and, in interface
+ * order, the report descriptor array of every HID interface it contains. Default
+ * is "desc_configuration:desc_hid_report". The device descriptor is read from
+ * "desc_device". Checks follow USB 2.0 chapter 9 and HID 1.11 for a full speed
+ * device; any error makes the tool exit non-zero so the build fails.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elf_file.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+#define MAX_HID_PER_CONFIG  8
+#define MAX_CONFIGS         8
+
+enum
+{
+  DESC_DEVICE        = 0x01,
+  DESC_CONFIGURATION = 0x02,
+  DESC_INTERFACE     = 0x04,
+  DESC_ENDPOINT      = 0x05,
+  DESC_IAD           = 0x0B,
+  DESC_HID           = 0x21,
+  DESC_HID_REPORT    = 0x22,
+  DESC_CS_INTERFACE  = 0x24,
+};
+
+enum
+{
+  CLASS_CDC      = 0x02,
+  CLASS_HID      = 0x03,
+  CLASS_CDC_DATA = 0x0A,
+};
+
+enum
+{
+  XFER_CONTROL = 0,
+  XFER_ISO,
+  XFER_BULK,
+  XFER_INTERRUPT
+};
+
+typedef struct
+{
+  char const* config;
+  char const* hid[MAX_HID_PER_CONFIG];
+  unsigned    hid_count;
+} config_arg_t;
+
+typedef struct
+{
+  char const* where;
+  unsigned    errors;
+  unsigned    warnings;
+  bool        verbose;
+} check_ctx_t;
+
+static void error(check_ctx_t* ctx, char const* fmt, ...)
+{
+  va_list ap;
+  va_start(ap, fmt);
+  fprintf(stderr, "desc_check: error: %s: ", ctx->where);
+  vfprintf(stderr, fmt, ap);
+  fputc('\n', stderr);
+  va_end(ap);
+  ctx->errors++;
+}
+
+static void warning(check_ctx_t* ctx, char const* fmt, ...)
+{
+  va_list ap;
+  va_start(ap, fmt);
+  fprintf(stderr, "desc_check: warning: %s: ", ctx->where);
+  vfprintf(stderr, fmt, ap);
+  fputc('\n', stderr);
+  va_end(ap);
+  ctx->warnings++;
+}
+
+static void info(check_ctx_t* ctx, char const* fmt, ...)
+{
+  if ( !ctx->verbose ) return;
+
+  va_list ap;
+  va_start(ap, fmt);
+  vprintf(fmt, ap);
+  va_end(ap);
+}
+
+static uint16_t rd16(uint8_t const* p) { return (uint16_t) (p[0] | (p[1] << 8)); }
+
+//--------------------------------------------------------------------+
+// Device Descriptor
+//--------------------------------------------------------------------+
+
+static void check_device(check_ctx_t* ctx, uint8_t const* d, size_t len, unsigned config_count)
+{
+  ctx->where = "desc_device";
+
+  if ( len != 18 || d[0] != 18 || d[1] != DESC_DEVICE )
+  {
+    error(ctx, "expected 18 byte device descriptor, got bLength %u type 0x%02X size %zu", d[0], d[1], len);
+    return;
+  }
+
+  uint16_t const bcd_usb = rd16(d + 2);
+  info(ctx, "Device: bcdUSB %04X class %02X/%02X/%02X EP0 %u VID %04X PID %04X bcdDevice %04X configs %u\n",
+       bcd_usb, d[4], d[5], d[6], d[7], rd16(d + 8), rd16(d + 10), rd16(d + 12), d[17]);
+
+  if ( bcd_usb != 0x0110 && bcd_usb != 0x0200 && bcd_usb != 0x0201 && bcd_usb != 0x0210 )
+  {
+    error(ctx, "bcdUSB 0x%04X is not a USB 1.1/2.x release number", bcd_usb);
+  }
+
+  // bcdUSB >= 2.01 makes hosts ask for a BOS descriptor
+  if ( bcd_usb == 0x0201 || bcd_usb == 0x0210 ) warning(ctx, "bcdUSB 0x%04X requires a BOS descriptor", bcd_usb);
+
+  if ( d[7] != 8 && d[7] != 16 && d[7] != 32 && d[7] != 64 )
+  {
+    error(ctx, "bMaxPacketSize0 %u must be 8, 16, 32 or 64", d[7]);
+  }
+
+  if ( d[17] == 0 ) error(ctx, "bNumConfigurations is zero");
+
+  if ( d[17] != config_count )
+  {
+    error(ctx, "bNumConfigurations %u but %u configuration descriptor(s) checked", d[17], config_count);
+  }
+}
+
+//--------------------------------------------------------------------+
+// HID Report Descriptor
+//--------------------------------------------------------------------+
+
+// Largest report (in bytes, including report ID) of each type
+typedef struct
+{
+  unsigned input_len;
+  unsigned output_len;
+  unsigned feature_len;
+} hid_report_sizes_t;
+
+typedef struct
+{
+  uint32_t usage_page;
+  int32_t  logical_min;
+  int32_t  logical_max;
+  uint32_t report_size;
+  uint32_t report_count;
+  uint32_t report_id;
+} hid_globals_t;
+
+#define HID_MAX_REPORT_ID   256
+#define HID_MAX_PUSH        8
+#define HID_MAX_COLLECTION  16
+
+static int32_t item_signed(uint8_t const* data, uint8_t size)
+{
+  switch ( size )
+  {
+    case 1: return (int8_t) data[0];
+    case 2: return (int16_t) rd16(data);
+    case 4: return (int32_t) ((uint32_t) rd16(data) | ((uint32_t) rd16(data + 2) << 16));
+    default: return 0;
+  }
+}
+
+static uint32_t item_unsigned(uint8_t const* data, uint8_t size)
+{
+  return (uint32_t) item_signed(data, size) & (size == 4 ? 0xFFFFFFFFu : (1u << (8 * size)) - 1);
+}
+
+static void check_hid_report(check_ctx_t* ctx, uint8_t const* d, size_t len, hid_report_sizes_t* sizes)
+{
+  // bit count per report ID and main item type (input, output, feature)
+  static uint32_t bits[HID_MAX_REPORT_ID][3];
+  memset(bits, 0, sizeof(bits));
+  memset(sizes, 0, sizeof(*sizes));
+
+  hid_globals_t g = { 0 };
+  hid_globals_t stack[HID_MAX_PUSH];
+  unsigned sp = 0;
+
+  unsigned depth = 0;
+  bool     has_app_collection = false;
+  bool     uses_report_id = false;
+  bool     main_without_id = false;
+  unsigned usages = 0;
+  bool     usage_min_set = false;
+  uint32_t usage_min = 0;
+
+  size_t i = 0;
+  while ( i < len )
+  {
+    uint8_t const prefix = d[i];
+
+    // long item: bDataSize, bLongItemTag, data
+    if ( prefix == 0xFE )
+    {
+      if ( i + 2 >= len || i + 3 + d[i + 1] > len )
+      {
+        error(ctx, "truncated long item at offset %zu", i);
+        return;
+      }
+      warning(ctx, "long item at offset %zu is reserved by HID 1.11", i);
+      i += 3 + d[i + 1];
+      continue;
+    }
+
+    uint8_t const size = (prefix & 0x03) == 3 ? 4 : (prefix & 0x03);
+    uint8_t const type = (prefix >> 2) & 0x03;
+    uint8_t const tag  = prefix >> 4;
+
+    if ( i + 1 + size > len )
+    {
+      error(ctx, "truncated item 0x%02X at offset %zu", prefix, i);
+      return;
+    }
+
+    uint8_t const* data = d + i + 1;
+    uint32_t const uval = item_unsigned(data, size);
+    int32_t  const sval = item_signed(data, size);
+
+    switch ( type )
+    {
+      case 0: // Main
+        switch ( tag )
+        {
+          case 0x8: case 0x9: case 0xB: // Input, Output, Feature
+          {
+            unsigned const kind = (tag == 0x8) ? 0 : (tag == 0x9) ? 1 : 2;
+            bool const is_const = uval & 0x01;
+            bool const is_var   = uval & 0x02;
+
+            if ( depth == 0 ) error(ctx, "main item at offset %zu outside any collection", i);
+            if ( g.report_size == 0 ) error(ctx, "main item at offset %zu without Report Size", i);
+            if ( g.report_count == 0 ) error(ctx, "main item at offset %zu without Report Count", i);
+            if ( uses_report_id && g.report_id == 0 ) main_without_id = true;
+            if ( !uses_report_id ) main_without_id = true;
+
+            if ( !is_const )
+            {
+              if ( !usages && !usage_min_set ) error(ctx, "data item at offset %zu has no Usage", i);
+
+              // logical range must be representable in the field (a zero size is reported above)
+              if ( g.report_size > 0 && g.report_size < 32 )
+              {
+                int64_t const lim_u = ((int64_t) 1 << g.report_size) - 1;
+                int64_t const lim_s = ((int64_t) 1 << (g.report_size - 1));
+
+                if ( g.logical_min > g.logical_max )
+                {
+                  error(ctx, "Logical Minimum %d > Logical Maximum %d at offset %zu", g.logical_min, g.logical_max, i);
+                }else if ( g.logical_min < 0 ? (g.logical_min < -lim_s || g.logical_max > lim_s - 1)
+                                             : (g.logical_max > lim_u) )
+                {
+                  error(ctx, "logical range %d..%d does not fit Report Size %u at offset %zu",
+                        g.logical_min, g.logical_max, g.report_size, i);
+                }
+              }
+
+              // an array needs one field per possible pressed usage, a variable one per usage
+              if ( is_var && usages > g.report_count )
+              {
+                warning(ctx, "%u usages but Report Count %u at offset %zu", usages, g.report_count, i);
+              }
+            }
+
+            bits[g.report_id][kind] += g.report_size * g.report_count;
+            break;
+          }
+
+          case 0xA: // Collection
+            if ( depth == 0 && uval != 0x01 ) error(ctx, "top level collection at offset %zu is not Application", i);
+            if ( depth == 0 ) has_app_collection = true;
+            if ( depth >= HID_MAX_COLLECTION )
+            {
+              error(ctx, "collections nested too deep at offset %zu", i);
+              return;
+            }
+            depth++;
+            break;
+
+          case 0xC: // End Collection
+            if ( depth == 0 )
+            {
+              error(ctx, "End Collection without Collection at offset %zu", i);
+            }else
+            {
+              depth--;
+            }
+            break;
+
+          default:
+            error(ctx, "unknown main item tag 0x%X at offset %zu", tag, i);
+            break;
+        }
+
+        // local items only apply to the next main item
+        usages = 0;
+        usage_min_set = false;
+        break;
+
+      case 1: // Global
+        switch ( tag )
+        {
+          case 0x0: g.usage_page = uval; break;
+          case 0x1: g.logical_min = sval; break;
+          case 0x2:
+            // an unsigned maximum is allowed when the minimum is not negative
+            g.logical_max = (g.logical_min >= 0 && size < 4) ? (int32_t) uval : sval;
+            break;
+          case 0x3: case 0x4: case 0x5: case 0x6: break; // physical min/max, unit exponent, unit
+          case 0x7:
+            g.report_size = uval;
+            if ( uval == 0 || uval > 32 ) error(ctx, "Report Size %u at offset %zu out of range", uval, i);
+            break;
+
+          case 0x8:
+            if ( uval == 0 || uval >= HID_MAX_REPORT_ID )
+            {
+              error(ctx, "Report ID %u at offset %zu must be 1..255", uval, i);
+              return;
+            }
+            g.report_id = uval;
+            uses_report_id = true;
+            break;
+
+          case 0x9: g.report_count = uval; break;
+
+          case 0xA: // Push
+            if ( sp >= HID_MAX_PUSH )
+            {
+              error(ctx, "Push nested too deep at offset %zu", i);
+              return;
+            }
+            stack[sp++] = g;
+            break;
+
+          case 0xB: // Pop
+            if ( sp == 0 )
+            {
+              error(ctx, "Pop without Push at offset %zu", i);
+            }else
+            {
+              g = stack[--sp];
+            }
+            break;
+
+          default:
+            error(ctx, "unknown global item tag 0x%X at offset %zu", tag, i);
+            break;
+        }
+        break;
+
+      case 2: // Local
+        switch ( tag )
+        {
+          case 0x0: // Usage
+            if ( size < 4 && g.usage_page == 0 ) error(ctx, "Usage at offset %zu before any Usage Page", i);
+            usages++;
+            break;
+
+          case 0x1:
+            usage_min = uval;
+            usage_min_set = true;
+            break;
+
+          case 0x2:
+            if ( !usage_min_set ) error(ctx, "Usage Maximum without Usage Minimum at offset %zu", i);
+            else if ( uval < usage_min ) error(ctx, "Usage Maximum < Usage Minimum at offset %zu", i);
+            else usages += uval - usage_min + 1;
+            break;
+
+          default: break; // designators, strings, delimiters
+        }
+        break;
+
+      default:
+        error(ctx, "reserved item type at offset %zu", i);
+        break;
+    }
+
+    i += 1 + size;
+  }
+
+  if ( depth != 0 ) error(ctx, "%u collection(s) not closed", depth);
+  if ( sp != 0 ) warning(ctx, "%u Push without Pop", sp);
+  if ( !has_app_collection ) error(ctx, "no Application collection");
+  if ( uses_report_id && main_without_id ) error(ctx, "mixes reports with and without Report ID");
+
+  char const* const kind_name[3] = { "input", "output", "feature" };
+  unsigned* const kind_max[3] = { &sizes->input_len, &sizes->output_len, &sizes->feature_len };
+
+  for ( unsigned id = 0; id < HID_MAX_REPORT_ID; id++ )
+  {
+    for ( unsigned k = 0; k < 3; k++ )
+    {
+      if ( !bits[id][k] ) continue;
+
+      if ( bits[id][k] % 8 ) error(ctx, "%s report %u is %u bits, not a whole number of bytes", kind_name[k], id, bits[id][k]);
+
+      unsigned const bytes = (bits[id][k] + 7) / 8 + (uses_report_id ? 1 : 0);
+      info(ctx, "    report %u %s: %u byte(s)\n", id, kind_name[k], bytes);
+
+      if ( bytes > *kind_max[k] ) *kind_max[k] = bytes;
+    }
+  }
+}
+
+//--------------------------------------------------------------------+
+// Configuration Descriptor
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  uint8_t  number;
+  uint8_t  cls;
+  uint8_t  num_ep;
+  uint8_t  ep_seen;
+  uint8_t  ep_in_type;    // bitmap of transfer types, IN direction
+  uint8_t  ep_out_type;   // bitmap of transfer types, OUT direction
+  uint16_t in_size;       // wMaxPacketSize of the interrupt IN endpoint
+  uint16_t report_len;    // HID: wDescriptorLength
+  bool     has_hid_desc;
+} itf_info_t;
+
+static void finish_interface(check_ctx_t* ctx, itf_info_t const* itf)
+{
+  if ( itf->ep_seen != itf->num_ep )
+  {
+    error(ctx, "interface %u declares %u endpoint(s) but has %u", itf->number, itf->num_ep, itf->ep_seen);
+  }
+
+  if ( itf->cls == CLASS_HID )
+  {
+    if ( !itf->has_hid_desc ) error(ctx, "HID interface %u has no HID descriptor", itf->number);
+    if ( !(itf->ep_in_type & (1u << XFER_INTERRUPT)) ) error(ctx, "HID interface %u has no interrupt IN endpoint", itf->number);
+  }
+
+  if ( itf->cls == CLASS_CDC_DATA )
+  {
+    if ( !(itf->ep_in_type & (1u << XFER_BULK)) || !(itf->ep_out_type & (1u << XFER_BULK)) )
+    {
+      error(ctx, "CDC data interface %u needs one bulk IN and one bulk OUT endpoint", itf->number);
+    }
+  }
+}
+
+static void check_configuration(check_ctx_t* ctx, elf_file_t const* elf, config_arg_t const* arg, uint8_t* config_values)
+{
+  size_t len = 0;
+  uint8_t const* d = elf_find_symbol(elf, arg->config, &len);
+
+  ctx->where = arg->config;
+
+  if ( !d )
+  {
+    error(ctx, "symbol not found in image");
+    return;
+  }
+
+  if ( len < 9 || d[0] != 9 || d[1] != DESC_CONFIGURATION )
+  {
+    error(ctx, "does not start with a 9 byte configuration descriptor");
+    return;
+  }
+
+  uint16_t const total_len = rd16(d + 2);
+  uint8_t  const num_itf   = d[4];
+  uint8_t  const attr      = d[7];
+
+  info(ctx, "Configuration %u (%s): wTotalLength %u interfaces %u attributes 0x%02X power %u mA\n",
+       d[5], arg->config, total_len, num_itf, attr, 2u * d[8]);
+
+  if ( total_len != len ) error(ctx, "wTotalLength %u but array is %zu bytes", total_len, len);
+  if ( d[5] == 0 ) error(ctx, "bConfigurationValue must not be zero");
+  if ( !(attr & 0x80) ) error(ctx, "bmAttributes bit 7 must be set");
+  if ( attr & 0x1F ) error(ctx, "bmAttributes reserved bits 0..4 must be zero");
+  if ( d[8] > 250 ) error(ctx, "bMaxPower %u mA exceeds 500 mA", 2u * d[8]);
+
+  // bConfigurationValue must be unique across configurations
+  for ( unsigned c = 0; c < MAX_CONFIGS && config_values[c]; c++ )
+  {
+    if ( config_values[c] == d[5] ) error(ctx, "duplicate bConfigurationValue %u", d[5]);
+  }
+  for ( unsigned c = 0; c < MAX_CONFIGS; c++ )
+  {
+    if ( !config_values[c] )
+    {
+      config_values[c] = d[5];
+      break;
+    }
+  }
+
+  uint32_t itf_seen = 0;        // bitmap of interface numbers (alt 0)
+  uint32_t ep_used[2] = { 0 };  // bitmap of endpoint numbers per direction
+  unsigned hid_index = 0;
+  itf_info_t itf = { 0 };
+  bool in_itf = false;
+
+  size_t i = 9;
+  while ( i < len && i < total_len )
+  {
+    uint8_t const blen  = d[i];
+    uint8_t const btype = (i + 1 < len) ? d[i + 1] : 0;
+
+    if ( blen < 2 || i + blen > len )
+    {
+      error(ctx, "descriptor at offset %zu has bad bLength %u", i, blen);
+      return;
+    }
+
+    uint8_t const* p = d + i;
+
+    switch ( btype )
+    {
+      case DESC_IAD:
+        if ( blen != 8 ) error(ctx, "IAD at offset %zu has bLength %u", i, blen);
+        info(ctx, "  IAD: interfaces %u..%u class %02X\n", p[2], p[2] + p[3] - 1, p[4]);
+        if ( p[3] == 0 || p[2] + p[3] > num_itf ) error(ctx, "IAD at offset %zu covers interfaces outside 0..%u", i, num_itf - 1);
+        break;
+
+      case DESC_INTERFACE:
+        if ( blen != 9 )
+        {
+          error(ctx, "interface descriptor at offset %zu has bLength %u", i, blen);
+          break;
+        }
+
+        if ( in_itf ) finish_interface(ctx, &itf);
+
+        memset(&itf, 0, sizeof(itf));
+        itf.number = p[2];
+        itf.num_ep = p[4];
+        itf.cls    = p[5];
+        in_itf     = true;
+
+        info(ctx, "  Interface %u alt %u: class %02X/%02X/%02X endpoints %u\n", p[2], p[3], p[5], p[6], p[7], p[4]);
+
+        if ( p[3] == 0 )
+        {
+          if ( p[2] >= 32 || (itf_seen & (1u << p[2])) ) error(ctx, "duplicate interface number %u", p[2]);
+          else itf_seen |= 1u << p[2];
+        }
+        break;
+
+      case DESC_HID:
+      {
+        if ( blen < 9 || (blen - 6) % 3 )
+        {
+          error(ctx, "HID descriptor at offset %zu has bLength %u", i, blen);
+          break;
+        }
+        if ( !in_itf || itf.cls != CLASS_HID ) error(ctx, "HID descriptor at offset %zu not inside a HID interface", i);
+
+        itf.has_hid_desc = true;
+        itf.report_len   = rd16(p + 7);
+
+        info(ctx, "    HID: bcdHID %04X country %u report descriptor %u bytes\n", rd16(p + 2), p[4], itf.report_len);
+
+        if ( p[5] == 0 || blen != 6 + 3 * p[5] ) error(ctx, "HID descriptor bNumDescriptors %u does not match bLength %u", p[5], blen);
+        if ( p[6] != DESC_HID_REPORT ) error(ctx, "HID descriptor first class descriptor type 0x%02X is not Report", p[6]);
+
+        if ( hid_index >= arg->hid_count )
+        {
+          error(ctx, "HID interface %u has no report descriptor symbol given", itf.number);
+        }else
+        {
+          size_t rlen = 0;
+          char const* const rname = arg->hid[hid_index];
+          uint8_t const* report = elf_find_symbol(elf, rname, &rlen);
+
+          if ( !report )
+          {
+            ctx->where = rname;
+            error(ctx, "symbol not found in image");
+            ctx->where = arg->config;
+          }else if ( rlen != itf.report_len )
+          {
+            error(ctx, "HID interface %u wDescriptorLength %u but %s is %zu bytes", itf.number, itf.report_len, rname, rlen);
+          }
+        }
+        hid_index++;
+        break;
+      }
+
+      case DESC_ENDPOINT:
+      {
+        if ( blen != 7 )
+        {
+          error(ctx, "endpoint descriptor at offset %zu has bLength %u", i, blen);
+          break;
+        }
+        if ( !in_itf ) error(ctx, "endpoint at offset %zu before any interface", i);
+
+        uint8_t  const addr     = p[2];
+        uint8_t  const num      = addr & 0x0F;
+        uint8_t  const dir_in   = (addr & 0x80) ? 1 : 0;
+        uint8_t  const xfer     = p[3] & 0x03;
+        uint16_t const max_size = rd16(p + 4) & 0x7FF;
+        uint8_t  const interval = p[6];
+
+        static char const* const xfer_name[] = { "control", "iso", "bulk", "interrupt" };
+        info(ctx, "    Endpoint 0x%02X: %s %s size %u interval %u\n", addr, xfer_name[xfer], dir_in ? "IN" : "OUT", max_size, interval);
+
+        itf.ep_seen++;
+        if ( dir_in )
+        {
+          itf.ep_in_type |= (uint8_t) (1u << xfer);
+          if ( xfer == XFER_INTERRUPT && !itf.in_size ) itf.in_size = max_size;
+        }else
+        {
+          itf.ep_out_type |= (uint8_t) (1u << xfer);
+        }
+
+        if ( addr & 0x70 ) error(ctx, "endpoint address 0x%02X has reserved bits set", addr);
+        if ( num == 0 ) error(ctx, "endpoint 0 must not be described");
+        if ( xfer == XFER_CONTROL ) error(ctx, "endpoint 0x%02X is a control endpoint", addr);
+
+        if ( ep_used[dir_in] & (1u << num) ) error(ctx, "duplicate endpoint address 0x%02X", addr);
+        ep_used[dir_in] |= 1u << num;
+
+        if ( max_size == 0 && xfer != XFER_ISO ) error(ctx, "endpoint 0x%02X has zero wMaxPacketSize", addr);
+
+        switch ( xfer )
+        {
+          case XFER_BULK:
+            if ( max_size != 8 && max_size != 16 && max_size != 32 && max_size != 64 )
+            {
+              error(ctx, "full speed bulk endpoint 0x%02X size %u must be 8, 16, 32 or 64", addr, max_size);
+            }
+            break;
+
+          case XFER_INTERRUPT:
+            if ( max_size > 64 ) error(ctx, "full speed interrupt endpoint 0x%02X size %u > 64", addr, max_size);
+            if ( interval == 0 ) error(ctx, "interrupt endpoint 0x%02X has bInterval 0", addr);
+            break;
+
+          case XFER_ISO:
+            if ( max_size > 1023 ) error(ctx, "full speed iso endpoint 0x%02X size %u > 1023", addr, max_size);
+            if ( interval < 1 || interval > 16 ) error(ctx, "iso endpoint 0x%02X bInterval %u not 1..16", addr, interval);
+            break;
+
+          default: break;
+        }
+        break;
+      }
+
+      case DESC_CS_INTERFACE:
+        if ( blen < 3 ) error(ctx, "class specific descriptor at offset %zu too short", i);
+        break;
+
+      default:
+        warning(ctx, "unexpected descriptor type 0x%02X at offset %zu", btype, i);
+        break;
+    }
+
+    i += blen;
+  }
+
+  if ( in_itf ) finish_interface(ctx, &itf);
+
+  if ( i != len ) error(ctx, "descriptors end at offset %zu but array is %zu bytes", i, len);
+
+  unsigned itf_count = 0;
+  for ( uint32_t b = itf_seen; b; b &= b - 1 ) itf_count++;
+
+  if ( itf_count != num_itf ) error(ctx, "bNumInterfaces %u but %u interface(s) found", num_itf, itf_count);
+  if ( itf_seen != ((num_itf >= 32) ? 0xFFFFFFFFu : (1u << num_itf) - 1) ) error(ctx, "interface numbers are not 0..%u", num_itf - 1);
+  if ( hid_index != arg->hid_count ) error(ctx, "%u HID report descriptor(s) given but %u HID interface(s) found", arg->hid_count, hid_index);
+}
+
+// Second pass: decode each HID report descriptor and check its reports fit the interrupt endpoint
+static void check_hid_reports(check_ctx_t* ctx, elf_file_t const* elf, config_arg_t const* arg)
+{
+  size_t len = 0;
+  uint8_t const* d = elf_find_symbol(elf, arg->config, &len);
+  if ( !d || len < 9 ) return;
+
+  unsigned hid_index = 0;
+  uint16_t report_len = 0;
+  bool pending = false;
+
+  for ( size_t i = 9; i + 1 < len && d[i] >= 2 && i + d[i] <= len; i += d[i] )
+  {
+    uint8_t const* p = d + i;
+
+    if ( p[1] == DESC_HID && p[0] >= 9 )
+    {
+      report_len = rd16(p + 7);
+      pending = true;
+    }
+
+    // first interrupt IN endpoint after the HID descriptor carries the input reports
+    if ( pending && p[1] == DESC_ENDPOINT && p[0] == 7 && (p[2] & 0x80) && (p[3] & 0x03) == XFER_INTERRUPT )
+    {
+      pending = false;
+      if ( hid_index >= arg->hid_count ) break;
+
+      char const* const rname = arg->hid[hid_index++];
+      size_t rlen = 0;
+      uint8_t const* report = elf_find_symbol(elf, rname, &rlen);
+      if ( !report ) continue;
+
+      ctx->where = rname;
+      info(ctx, "HID report descriptor %s: %zu bytes\n", rname, rlen);
+      if ( rlen != report_len ) continue; // already reported by check_configuration
+
+      hid_report_sizes_t sizes;
+      check_hid_report(ctx, report, rlen, &sizes);
+
+      uint16_t const ep_size = rd16(p + 4) & 0x7FF;
+      if ( sizes.input_len > ep_size )
+      {
+        error(ctx, "largest input report is %u bytes but endpoint 0x%02X wMaxPacketSize is %u", sizes.input_len, p[2], ep_size);
+      }
+    }
+  }
+}
+
+//--------------------------------------------------------------------+
+// MAIN
+//--------------------------------------------------------------------+
+
+static bool parse_config_arg(char* s, config_arg_t* arg)
+{
+  memset(arg, 0, sizeof(*arg));
+
+  char* colon = strchr(s, ':');
+  arg->config = s;
+  if ( !colon ) return true;
+
+  *colon = 0;
+  for ( char* tok = strtok(colon + 1, ","); tok; tok = strtok(NULL, ",") )
+  {
+    if ( arg->hid_count >= MAX_HID_PER_CONFIG ) return false;
+    arg->hid[arg->hid_count++] = tok;
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  check_ctx_t ctx = { .where = "" };
+  config_arg_t configs[MAX_CONFIGS];
+  unsigned config_count = 0;
+  char const* path = NULL;
+
+  for ( int i = 1; i < argc; i++ )
+  {
+    if ( !strcmp(argv[i], "-v") )
+    {
+      ctx.verbose = true;
+    }else if ( !path )
+    {
+      path = argv[i];
+    }else if ( config_count < MAX_CONFIGS && parse_config_arg(argv[i], &configs[config_count]) )
+    {
+      config_count++;
+    }else
+    {
+      fprintf(stderr, "desc_check: bad argument '%s'\n", argv[i]);
+      return 2;
+    }
+  }
+
+  if ( !path )
+  {
+    fprintf(stderr, "usage: desc_check [-v] firmware.elf [config[:hid_report[,hid_report...]]]...\n");
+    return 2;
+  }
+
+  if ( config_count == 0 )
+  {
+    static char default_arg[] = "desc_configuration:desc_hid_report";
+    parse_config_arg(default_arg, &configs[0]);
+    config_count = 1;
+  }
+
+  elf_file_t elf;
+  if ( !elf_open(&elf, path) )
+  {
+    fprintf(stderr, "desc_check: cannot read ELF file '%s'\n", path);
+    return 2;
+  }
+
+  size_t dev_len = 0;
+  uint8_t const* dev = elf_find_symbol(&elf, "desc_device", &dev_len);
+  if ( dev )
+  {
+    check_device(&ctx, dev, dev_len, config_count);
+  }else
+  {
+    ctx.where = "desc_device";
+    error(&ctx, "symbol not found in image");
+  }
+
+  uint8_t config_values[MAX_CONFIGS] = { 0 };
+  for ( unsigned c = 0; c < config_count; c++ )
+  {
+    check_configuration(&ctx, &elf, &configs[c], config_values);
+    check_hid_reports(&ctx, &elf, &configs[c]);
+  }
+
+  elf_close(&elf);
+
+  printf("desc_check: %s: %u error(s), %u warning(s)\n", path, ctx.errors, ctx.warnings);
+  return ctx.errors ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elf_file.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+enum
+{
+  EI_CLASS   = 4,
+  EI_DATA    = 5,
+  ELFCLASS32 = 1,
+  ELFCLASS64 = 2,
+  ELFDATA2LSB = 1,
+
+  SHT_SYMTAB = 2,
+  SHT_NOBITS = 8,
+  SHN_UNDEF  = 0,
+  SHN_LORESERVE = 0xff00,
+};
+
+// Fields of the section header / symbol we care about, widened to 64-bit
+typedef struct
+{
+  uint32_t name;
+  uint32_t type;
+  uint64_t addr;
+  uint64_t offset;
+  uint64_t size;
+  uint32_t link;
+  uint64_t entsize;
+} elf_shdr_t;
+
+typedef struct
+{
+  uint32_t name;
+  uint16_t shndx;
+  uint64_t value;
+  uint64_t size;
+} elf_sym_t;
+
+//--------------------------------------------------------------------+
+// Little-endian accessors
+//--------------------------------------------------------------------+
+
+static uint16_t rd16(uint8_t const* p) { return (uint16_t) (p[0] | (p[1] << 8)); }
+static uint32_t rd32(uint8_t const* p) { return (uint32_t) rd16(p) | ((uint32_t) rd16(p + 2) << 16); }
+static uint64_t rd64(uint8_t const* p) { return (uint64_t) rd32(p) | ((uint64_t) rd32(p + 4) << 32); }
+
+static bool in_file(elf_file_t const* elf, uint64_t offset, uint64_t len)
+{
+  return offset <= elf->size && len <= elf->size - offset;
+}
+
+static bool read_shdr(elf_file_t const* elf, unsigned index, elf_shdr_t* sh)
+{
+  uint8_t const* eh = elf->data;
+  uint64_t shoff    = elf->is64 ? rd64(eh + 0x28) : rd32(eh + 0x20);
+  uint16_t shentsz  = elf->is64 ? rd16(eh + 0x3A) : rd16(eh + 0x2E);
+  uint16_t shnum    = elf->is64 ? rd16(eh + 0x3C) : rd16(eh + 0x30);
+
+  if ( index >= shnum ) return false;
+  if ( !in_file(elf, shoff + (uint64_t) index * shentsz, shentsz) ) return false;
+
+  uint8_t const* p = elf->data + shoff + (uint64_t) index * shentsz;
+  sh->name = rd32(p);
+  sh->type = rd32(p + 4);
+
+  if ( elf->is64 )
+  {
+    sh->addr    = rd64(p + 0x10);
+    sh->offset  = rd64(p + 0x18);
+    sh->size    = rd64(p + 0x20);
+    sh->link    = rd32(p + 0x28);
+    sh->entsize = rd64(p + 0x38);
+  }else
+  {
+    sh->addr    = rd32(p + 0x0C);
+    sh->offset  = rd32(p + 0x10);
+    sh->size    = rd32(p + 0x14);
+    sh->link    = rd32(p + 0x18);
+    sh->entsize = rd32(p + 0x24);
+  }
+
+  return true;
+}
+
+static void read_sym(elf_file_t const* elf, uint8_t const* p, elf_sym_t* sym)
+{
+  sym->name = rd32(p);
+
+  if ( elf->is64 )
+  {
+    sym->shndx = rd16(p + 6);
+    sym->value = rd64(p + 8);
+    sym->size  = rd64(p + 16);
+  }else
+  {
+    sym->value = rd32(p + 4);
+    sym->size  = rd32(p + 8);
+    sym->shndx = rd16(p + 14);
+  }
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+bool elf_open(elf_file_t* elf, char const* path)
+{
+  memset(elf, 0, sizeof(*elf));
+
+  FILE* f = fopen(path, "rb");
+  if ( !f ) return false;
+
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+
+  if ( len < 0x40 )
+  {
+    fclose(f);
+    return false;
+  }
+
+  elf->data = malloc((size_t) len);
+  elf->size = (size_t) len;
+
+  bool ok = elf->data && fread(elf->data, 1, elf->size, f) == elf->size;
+  fclose(f);
+
+  ok = ok && !memcmp(elf->data, "\x7f" "ELF", 4) && elf->data[EI_DATA] == ELFDATA2LSB &&
+       (elf->data[EI_CLASS] == ELFCLASS32 || elf->data[EI_CLASS] == ELFCLASS64);
+
+  if ( !ok )
+  {
+    elf_close(elf);
+    return false;
+  }
+
+  elf->is64 = (elf->data[EI_CLASS] == ELFCLASS64);
+  return true;
+}
+
+void elf_close(elf_file_t* elf)
+{
+  free(elf->data);
+  memset(elf, 0, sizeof(*elf));
+}
+
+uint8_t const* elf_find_symbol(elf_file_t const* elf, char const* name, size_t* size)
+{
+  elf_shdr_t symtab;
+  unsigned idx = 0;
+
+  // locate the (single) static symbol table
+  while ( read_shdr(elf, idx, &symtab) && symtab.type != SHT_SYMTAB ) idx++;
+  if ( symtab.type != SHT_SYMTAB || !symtab.entsize ) return NULL;
+
+  elf_shdr_t strtab;
+  if ( !read_shdr(elf, symtab.link, &strtab) ) return NULL;
+  if ( !in_file(elf, symtab.offset, symtab.size) || !in_file(elf, strtab.offset, strtab.size) ) return NULL;
+
+  char const* strings = (char const*) elf->data + strtab.offset;
+
+  for ( uint64_t off = 0; off + symtab.entsize <= symtab.size; off += symtab.entsize )
+  {
+    elf_sym_t sym;
+    read_sym(elf, elf->data + symtab.offset + off, &sym);
+
+    if ( sym.name >= strtab.size ) continue;
+    if ( strncmp(strings + sym.name, name, strtab.size - sym.name) ) continue;
+    if ( sym.shndx == SHN_UNDEF || sym.shndx >= SHN_LORESERVE ) continue;
+
+    elf_shdr_t sec;
+    if ( !read_shdr(elf, sym.shndx, &sec) || sec.type == SHT_NOBITS ) return NULL;
+
+    // relocatable objects have section relative symbol values, linked images absolute ones
+    uint64_t rel = (sym.value >= sec.addr) ? sym.value - sec.addr : sym.value;
+    if ( rel > sec.size || sym.size > sec.size - rel ) return NULL;
+    if ( !in_file(elf, sec.offset + rel, sym.size) ) return NULL;
+
+    if ( size ) *size = (size_t) sym.size;
+    return elf->data + sec.offset + rel;
+  }
+
+  return NULL;
+}
+
+uint8_t const* elf_find_section(elf_file_t const* elf, char const* name, size_t* size)
+{
+  uint16_t const shstrndx = elf->is64 ? rd16(elf->data + 0x3E) : rd16(elf->data + 0x32);
+
+  elf_shdr_t names;
+  if ( !read_shdr(elf, shstrndx, &names) || !in_file(elf, names.offset, names.size) ) return NULL;
+
+  char const* strings = (char const*) elf->data + names.offset;
+
+  elf_shdr_t sec;
+  for ( unsigned idx = 0; read_shdr(elf, idx, &sec); idx++ )
+  {
+    if ( sec.name >= names.size ) continue;
+    if ( strncmp(strings + sec.name, name, names.size - sec.name) ) continue;
+    if ( sec.type == SHT_NOBITS || !in_file(elf, sec.offset, sec.size) ) return NULL;
+
+    if ( size ) *size = (size_t) sec.size;
+    return elf->data + sec.offset;
+  }
+
+  return NULL;
+}
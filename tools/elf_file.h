@@ -0,0 +1,53 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ELF_FILE_H_
+#define ELF_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Minimal read-only view of a little-endian ELF32/ELF64 file, enough to pull
+// the initialised bytes of a named data symbol out of a firmware image.
+typedef struct
+{
+  uint8_t* data;
+  size_t   size;
+  bool     is64;
+} elf_file_t;
+
+bool elf_open(elf_file_t* elf, char const* path);
+void elf_close(elf_file_t* elf);
+
+// Return pointer to the file bytes backing symbol 'name' and its size, or NULL
+// if the symbol does not exist or has no file contents (e.g lives in .bss)
+uint8_t const* elf_find_symbol(elf_file_t const* elf, char const* name, size_t* size);
+
+// Return pointer to the file bytes of section 'name' and its size, or NULL if
+// the section does not exist or has no file contents
+uint8_t const* elf_find_section(elf_file_t const* elf, char const* name, size_t* size);
+
+#endif /* ELF_FILE_H_ */
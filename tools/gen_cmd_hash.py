@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2026 pico-mouse contributors
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+"""Generate a minimal perfect hash of the console command names.
+
+    gen_cmd_hash.py console_cmds.def cmd_hash.h
+
+Reads the CONSOLE_CMD(id, name, handler, help) entries and writes the tables
+for a hash-and-displace lookup: the name is hashed once with seed 0 to pick a
+bucket, then again with the bucket's displacement as seed to pick the slot.
+Every command lands in its own slot of a table exactly as large as the command
+set. cmd_hash() in console.c must stay identical to fnv1a() here.
+"""
+
+import re
+import sys
+
+ENTRY = re.compile(r'^\s*CONSOLE_CMD\(\s*(\w+)\s*,\s*(\w+)\s*,', re.MULTILINE)
+
+# Buckets of about two names keep the displacement search short
+BUCKET_LOAD = 2
+MAX_DISPLACEMENT = 0xFFFF
+
+
+def fnv1a(name, seed):
+    h = (0x811C9DC5 ^ seed) & 0xFFFFFFFF
+    for c in name.encode():
+        h = ((h ^ c) * 0x01000193) & 0xFFFFFFFF
+    # the low bits of FNV-1a depend only on the low bits of seed and input, fold the high ones in
+    return h ^ (h >> 16)
+
+
+def build(names):
+    size = len(names)
+    buckets = max(1, (size + BUCKET_LOAD - 1) // BUCKET_LOAD)
+
+    members = [[] for _ in range(buckets)]
+    for cmd_id, name in enumerate(names):
+        members[fnv1a(name, 0) % buckets].append(cmd_id)
+
+    displace = [0] * buckets
+    slots = [None] * size
+
+    # largest buckets first, while most slots are still free
+    for b in sorted(range(buckets), key=lambda b: -len(members[b])):
+        if not members[b]:
+            continue
+        for d in range(1, MAX_DISPLACEMENT + 1):
+            wanted = [fnv1a(names[i], d) % size for i in members[b]]
+            if len(set(wanted)) == len(wanted) and all(slots[s] is None for s in wanted):
+                break
+        else:
+            sys.exit("gen_cmd_hash: no displacement found for bucket %d" % b)
+
+        displace[b] = d
+        for i, s in zip(members[b], wanted):
+            slots[s] = i
+
+    return displace, slots
+
+
+def c_array(values, per_line=12):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("  " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    with open(sys.argv[1]) as f:
+        entries = ENTRY.findall(f.read())
+    names = [name for _, name in entries]
+    if not names:
+        sys.exit("gen_cmd_hash: no CONSOLE_CMD entries in " + sys.argv[1])
+    if len(set(names)) != len(names):
+        sys.exit("gen_cmd_hash: duplicate command name")
+
+    displace, slots = build(names)
+
+    out = """// Generated by tools/gen_cmd_hash.py from {src}, do not edit
+
+#ifndef CMD_HASH_H_
+#define CMD_HASH_H_
+
+#include <stdint.h>
+
+#define CMD_HASH_SIZE     {size}
+#define CMD_HASH_BUCKETS  {buckets}
+
+// Seed of the second hash for each bucket
+static uint16_t const cmd_hash_displace[CMD_HASH_BUCKETS] =
+{{
+{displace}
+}};
+
+// Command id in each slot
+static uint8_t const cmd_hash_slot[CMD_HASH_SIZE] =
+{{
+{slots}
+}};
+
+#endif /* CMD_HASH_H_ */
+""".format(src=sys.argv[1].replace("\\", "/").split("/")[-1], size=len(slots), buckets=len(displace),
+           displace=c_array(displace), slots=c_array(slots))
+
+    with open(sys.argv[2], "w") as f:
+        f.write(out)
+
+
+if __name__ == "__main__":
+    main()
@@ -88,12 +88,12 @@
 
 #ifndef CFG_TUD_ENDPOINT0_SIZE    
 #define CFG_TUD_ENDPOINT0_SIZE  64
-#define CFG_TUD_CDC_RX_BUFSIZE  64
-#define CFG_TUD_CDC_TX_BUFSIZE  64
+#define CFG_TUD_CDC_RX_BUFSIZE  512 // a flash page of update data arrives while the previous one is programmed
+#define CFG_TUD_CDC_TX_BUFSIZE  512 // room for several packets so bulk IN streams at full rate
 #endif
 
 //------------- CLASS -------------//
-#define CFG_TUD_HID               1
+#define CFG_TUD_HID               2   // mouse, plus high resolution mouse in the high-rate configuration
 #define CFG_TUD_CDC               1
 #define CFG_TUD_MSC               0
 #define CFG_TUD_MIDI              0
@@ -0,0 +1,436 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hardware/flash.h"
+#include "hardware/watchdog.h"
+#include "pico/time.h"
+#include "tusb.h"
+
+#include "app_config.h"
+#include "boot_record.h"
+#include "console.h"
+#include "crc.h"
+#include "event_log.h"
+#include "flash_layout.h"
+#include "flash_service.h"
+#include "kv.h"
+#include "update.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+// Value of KV_KEY_UPDATE: the image committed to the free slot, checked by the boot that follows
+typedef struct
+{
+  uint32_t size;
+  uint32_t crc;
+} update_record_t;
+
+typedef enum
+{
+  UPDATE_IDLE,
+  UPDATE_ERASING,
+  UPDATE_RECEIVING,
+  UPDATE_VERIFYING,
+  UPDATE_VERIFIED,
+  UPDATE_FAILED,
+  UPDATE_REBOOTING,
+} update_state_t;
+
+static char const* const state_names[] = { "idle", "erasing", "receiving", "verifying", "verified", "failed",
+                                           "rebooting" };
+
+// Images go to the slot this one does not run from
+#define UPDATE_SLOT         (CFG_FIRMWARE_SLOT ^ 1)
+#define UPDATE_SLOT_OFFSET  FLASH_SLOT_OFFSET(UPDATE_SLOT)
+#define UPDATE_SLOT_SECTORS (FLASH_SLOT_SIZE / FLASH_SECTOR_SIZE)
+
+// boot2, checked by the boot ROM, is the first 252 bytes followed by their CRC
+#define BOOT2_SIZE          252
+
+// The vector table follows boot2, its reset handler must be in the slot the image is for
+#define VECTORS_OFFSET      0x100
+
+static struct
+{
+  update_state_t state;
+  update_record_t image;
+  uint32_t blank;        // sectors at the start of the free slot known to be erased
+  uint32_t erase_ms;     // last erase while suspended
+  bool waiting;          // "update begin" was told the erase waits for an idle bus
+  uint32_t received;     // bytes read from CDC
+  uint32_t written;      // bytes programmed, a multiple of FLASH_PAGE_SIZE
+  uint32_t fill;         // bytes in page_buf
+  uint32_t verified;     // bytes of the slot checked so far
+  uint32_t crc;          // their CRC-32
+  uint32_t start_ms;     // erased, transfer started
+  uint32_t last_ms;      // last data received, or commit time while rebooting
+  uint32_t elapsed_ms;   // transfer start to verified
+  char const* error;
+} upd;
+
+// Also the boot record page
+static uint8_t page_buf[FLASH_PAGE_SIZE];
+
+static uint32_t now_ms(void)
+{
+  return to_ms_since_boot(get_absolute_time());
+}
+
+static inline uint32_t image_sectors(uint32_t size)
+{
+  return (size + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE;
+}
+
+static void fail(char const* error)
+{
+  upd.state = UPDATE_FAILED;
+  upd.error = error;
+  console_printf("update failed: %s\r\n", error);
+}
+
+static bool sector_blank(uint32_t offset)
+{
+  uint32_t const* words = (uint32_t const*) FLASH_XIP(offset);
+
+  for ( uint32_t i = 0; i < FLASH_SECTOR_SIZE / 4; i++ )
+  {
+    if ( words[i] != 0xFFFFFFFFu ) return false;
+  }
+
+  return true;
+}
+
+// CRC the boot ROM checks boot2 with: CRC-32/MPEG-2, MSB first, no final inversion
+static bool boot2_valid(uint8_t const* image)
+{
+  uint32_t crc = 0xFFFFFFFFu;
+
+  for ( uint32_t i = 0; i < BOOT2_SIZE; i++ )
+  {
+    crc ^= (uint32_t) image[i] << 24;
+    for ( int bit = 0; bit < 8; bit++ ) crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : crc << 1;
+  }
+
+  uint32_t stored;
+  memcpy(&stored, image + BOOT2_SIZE, sizeof(stored));
+  return crc == stored;
+}
+
+// The image was linked for the free slot, not for the one running: the boot stage checks the same
+static bool linked_for_slot(uint8_t const* image)
+{
+  uint32_t reset;
+  memcpy(&reset, image + VECTORS_OFFSET + 4, sizeof(reset));
+  return (reset & 1) && reset - (XIP_BASE + UPDATE_SLOT_OFFSET) < FLASH_SLOT_SIZE;
+}
+
+//--------------------------------------------------------------------+
+// Boot record
+//--------------------------------------------------------------------+
+
+// Append a record selecting 'slot' after the newest one. Past the end of a sector the
+// other sector is erased first (once per BOOT_RECORDS / 2 updates, right before the
+// reboot): it only holds records older than the newest, which is never erased.
+static bool select_slot(uint32_t slot)
+{
+  int32_t const newest = boot_record_newest();
+  uint32_t const seq = newest < 0 ? 0 : (boot_record_at(newest)->value >> 1) + 1;
+  uint32_t const per_sector = BOOT_RECORDS / 2;
+
+  // skip records a write cut short left half programmed
+  uint32_t index = (uint32_t) (newest + 1) % BOOT_RECORDS;
+  while ( index % per_sector && !boot_record_erased(boot_record_at(index)) ) index++;
+
+  if ( index % per_sector == 0 )
+  {
+    index %= BOOT_RECORDS;
+    uint32_t const sector = FLASH_BOOT_RECORD_OFFSET + index * sizeof(boot_record_t);
+    if ( !sector_blank(sector) && !flash_service_erase(sector, FLASH_SECTOR_SIZE) ) return false;
+  }
+
+  boot_record_t const rec = { .value = seq << 1 | slot, .inverse = ~(seq << 1 | slot) };
+  uint32_t const offset = FLASH_BOOT_RECORD_OFFSET + index * sizeof(boot_record_t);
+
+  // programming leaves the 0xFF bytes of the page, the other records, alone
+  memset(page_buf, 0xFF, sizeof(page_buf));
+  memcpy(page_buf + offset % FLASH_PAGE_SIZE, &rec, sizeof(rec));
+  if ( !flash_service_program(offset - offset % FLASH_PAGE_SIZE, page_buf, FLASH_PAGE_SIZE) ) return false;
+
+  return boot_record_newest() == (int32_t) index;
+}
+
+//--------------------------------------------------------------------+
+// Erase, receive and verify
+//--------------------------------------------------------------------+
+
+// Keeps the free slot erased ahead of the next image, a sector per call. Blank sectors are
+// only read; a sector that needs erasing waits for an idle bus, since each erase stalls an
+// active one (flash_service.h), and while suspended for CFG_UPDATE_SUSPEND_ERASE_MS since the
+// last, so the erase current averages out near the suspend budget.
+// Returns false while an erase is held back for the bus.
+static bool erase_task(void)
+{
+  if ( upd.blank == UPDATE_SLOT_SECTORS ) return true;
+
+  uint32_t const offset = UPDATE_SLOT_OFFSET + upd.blank * FLASH_SECTOR_SIZE;
+  if ( !sector_blank(offset) )
+  {
+    if ( flash_service_erase_stalls() ) return false;
+    if ( tud_suspended() && now_ms() - upd.erase_ms < CFG_UPDATE_SUSPEND_ERASE_MS ) return true;
+
+    upd.erase_ms = now_ms();
+    if ( !flash_service_erase(offset, FLASH_SECTOR_SIZE) ) return true;
+  }
+
+  upd.blank++;
+  return true;
+}
+
+// "update begin" waits until the sectors the image needs are erased
+static void begin_task(void)
+{
+  if ( !erase_task() && !upd.waiting )
+  {
+    console_printf("slot %c not erased yet, it is erased while the bus is idle (suspended or not configured)\r\n",
+                   'A' + UPDATE_SLOT);
+    upd.waiting = true;
+  }
+
+  if ( upd.blank < image_sectors(upd.image.size) ) return;
+
+  upd.state = UPDATE_RECEIVING;
+  upd.start_ms = upd.last_ms = now_ms();
+  upd.blank = 0;  // the image goes in now, a later one starts with a rescan
+
+  // the host waits for this line before it sends the image
+  console_printf("ready for %lu bytes\r\n", (unsigned long) upd.image.size);
+}
+
+static void receive_task(void)
+{
+  uint32_t const now = now_ms();
+
+  if ( upd.fill < FLASH_PAGE_SIZE && upd.received < upd.image.size && tud_cdc_available() )
+  {
+    uint32_t const want = tu_min32(FLASH_PAGE_SIZE - upd.fill, upd.image.size - upd.received);
+    uint32_t const n = tud_cdc_read(page_buf + upd.fill, want);
+
+    upd.fill += n;
+    upd.received += n;
+    upd.last_ms = now;
+  }else if ( upd.received < upd.image.size && now - upd.last_ms > CFG_UPDATE_TIMEOUT_MS )
+  {
+    fail("timeout");
+    return;
+  }
+
+  // a full page, or the last one: program it, one page per loop iteration
+  if ( upd.fill == FLASH_PAGE_SIZE || (upd.fill && upd.received == upd.image.size) )
+  {
+    uint32_t const offset = UPDATE_SLOT_OFFSET + upd.written;
+
+    memset(page_buf + upd.fill, 0xFF, FLASH_PAGE_SIZE - upd.fill);
+
+    if ( !flash_service_program(offset, page_buf, FLASH_PAGE_SIZE) )
+    {
+      fail("flash write");
+      return;
+    }
+
+    upd.written += FLASH_PAGE_SIZE;
+    upd.fill = 0;
+  }
+
+  if ( upd.received == upd.image.size && upd.fill == 0 )
+  {
+    upd.state = UPDATE_VERIFYING;
+  }
+}
+
+// A chunk per loop iteration, so reports keep flowing during the check
+static void verify_task(void)
+{
+  uint32_t const n = tu_min32(CFG_UPDATE_VERIFY_CHUNK, upd.image.size - upd.verified);
+
+  upd.crc = crc32_update(upd.crc, FLASH_XIP(UPDATE_SLOT_OFFSET + upd.verified), n);
+  upd.verified += n;
+  if ( upd.verified < upd.image.size ) return;
+
+  if ( upd.crc != upd.image.crc )
+  {
+    fail("CRC mismatch");
+    return;
+  }
+
+  if ( !boot2_valid(FLASH_XIP(UPDATE_SLOT_OFFSET)) )
+  {
+    fail("no valid boot2, not a .bin image for this board");
+    return;
+  }
+
+  if ( !linked_for_slot(FLASH_XIP(UPDATE_SLOT_OFFSET)) )
+  {
+    fail(UPDATE_SLOT ? "not linked for slot B, send the _b build" : "not linked for slot A");
+    return;
+  }
+
+  upd.state = UPDATE_VERIFIED;
+  upd.elapsed_ms = now_ms() - upd.start_ms;
+  console_printf("update verified, %lu bytes in %lu ms, 'update commit' boots it\r\n",
+                 (unsigned long) upd.image.size, (unsigned long) upd.elapsed_ms);
+}
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void update_init(void)
+{
+  update_record_t rec;
+  if ( kv_get(KV_KEY_UPDATE, &rec, sizeof(rec)) != (int) sizeof(rec) ) return;
+
+  // the boot stage started the committed slot, and it holds the image that was verified: we are it.
+  // Otherwise the stage fell back to the old slot, or the record was never written.
+  bool const started = boot_record_slot() == CFG_FIRMWARE_SLOT && rec.size && rec.size <= FLASH_SLOT_SIZE &&
+                       crc32_update(0, FLASH_XIP(FLASH_SLOT_OFFSET(CFG_FIRMWARE_SLOT)), rec.size) == rec.crc;
+
+  kv_delete(KV_KEY_UPDATE);
+  event_log(LOG_EV_UPDATE, started, rec.size);
+}
+
+void update_task(void)
+{
+  switch ( upd.state )
+  {
+    case UPDATE_IDLE:
+    case UPDATE_FAILED:
+      erase_task();
+      break;
+
+    case UPDATE_ERASING:
+      begin_task();
+      break;
+
+    case UPDATE_RECEIVING:
+      receive_task();
+      break;
+
+    case UPDATE_VERIFYING:
+      verify_task();
+      break;
+
+    case UPDATE_REBOOTING:
+      // give the console time to send the reply first
+      if ( now_ms() - upd.last_ms >= 100 )
+      {
+        watchdog_reboot(0, 0, 0);
+        while ( 1 ) { }
+      }
+      break;
+
+    default: break;
+  }
+}
+
+bool update_receiving(void)
+{
+  return upd.state == UPDATE_RECEIVING;
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void update_cmd(int argc, char* argv[])
+{
+  if ( argc == 4 && !strcmp(argv[1], "begin") )
+  {
+    uint32_t const size = strtoul(argv[2], NULL, 0);
+    if ( size < FLASH_PAGE_SIZE || size > FLASH_SLOT_SIZE )
+    {
+      console_printf("image size must be %u .. %lu bytes\r\n", FLASH_PAGE_SIZE, (unsigned long) FLASH_SLOT_SIZE);
+      return;
+    }
+
+    // what is known to be erased stays known
+    uint32_t const blank = upd.state == UPDATE_IDLE || upd.state == UPDATE_FAILED ? upd.blank : 0;
+    uint32_t const erase_ms = upd.erase_ms;
+
+    memset(&upd, 0, sizeof(upd));
+    upd.state = UPDATE_ERASING;
+    upd.blank = blank;
+    upd.erase_ms = erase_ms;
+    upd.image.size = size;
+    upd.image.crc = strtoul(argv[3], NULL, 16);
+    return;
+  }
+
+  if ( argc == 2 && !strcmp(argv[1], "commit") )
+  {
+    if ( upd.state != UPDATE_VERIFIED )
+    {
+      console_printf("no verified image\r\n");
+      return;
+    }
+
+    // the boot record is the switch, the key only lets the next boot log the outcome
+    if ( !kv_set(KV_KEY_UPDATE, &upd.image, sizeof(upd.image)) )
+    {
+      fail("commit record not written");
+      return;
+    }
+
+    if ( !select_slot(UPDATE_SLOT) )
+    {
+      kv_delete(KV_KEY_UPDATE);
+      fail("boot record not written");
+      return;
+    }
+
+    console_printf("rebooting into slot %c\r\n", 'A' + UPDATE_SLOT);
+    upd.state = UPDATE_REBOOTING;
+    upd.last_ms = now_ms();
+    return;
+  }
+
+  if ( argc == 2 && !strcmp(argv[1], "abort") )
+  {
+    upd.state = UPDATE_IDLE;
+    return;
+  }
+
+  console_printf("%s, %lu/%lu bytes received", state_names[upd.state],
+                 (unsigned long) upd.received, (unsigned long) upd.image.size);
+  if ( upd.state == UPDATE_FAILED ) console_printf(": %s", upd.error);
+  if ( upd.elapsed_ms ) console_printf(", %lu KB/s", (unsigned long) (upd.image.size / upd.elapsed_ms));
+  console_printf("\r\nrunning slot %c, free slot %c at 0x%06lx, up to %lu bytes, %lu KB erased\r\n",
+                 'A' + CFG_FIRMWARE_SLOT, 'A' + UPDATE_SLOT, (unsigned long) UPDATE_SLOT_OFFSET,
+                 (unsigned long) FLASH_SLOT_SIZE, (unsigned long) (upd.blank * FLASH_SECTOR_SIZE / 1024));
+}
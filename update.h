@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef UPDATE_H_
+#define UPDATE_H_
+
+#include <stdbool.h>
+
+/* Firmware update over the CDC console, A/B.
+ *
+ * The firmware is linked for two slots (flash_layout.h), the boot stage at the
+ * start of flash starts the one the boot record names (boot_record.h). An
+ * update goes to the slot this image does not run from, the free slot.
+ *
+ * The free slot is erased ahead of time, a sector per main loop iteration and
+ * only while the bus is idle (suspended or not configured), since every erase
+ * stalls an active bus. "update begin <bytes> <crc32>" waits until the sectors
+ * the image needs are erased, then switches the CDC interface from command
+ * lines to raw data: the next <bytes> bytes are a .bin image, programmed page by
+ * page into the slot while HID reports keep flowing. The slot is then checked
+ * with the DMA sniffer CRC-32 against <crc32>, the boot2 CRC of the first page
+ * and the reset vector, which must point into the free slot.
+ *
+ * "update commit" appends a boot record selecting the free slot, one atomic
+ * write, and reboots: the boot stage starts the new image, nothing is copied.
+ * Power lost before the record is written leaves the old image running. The
+ * size and CRC are kept in the key-value store so that update_init() logs the
+ * outcome at the next boot.
+ */
+
+// Log the outcome of a committed update, call after kv_init() and event_log_init()
+void update_init(void);
+
+// Erase the free slot, receive and verify an image; call once per main loop iteration, suspended too
+void update_task(void);
+
+// True while CDC data belongs to an image, not to the console
+bool update_receiving(void);
+
+// Console: update [begin <bytes> <crc32> | commit | abort]
+void update_cmd(int argc, char* argv[]);
+
+#endif /* UPDATE_H_ */
@@ -26,6 +26,7 @@
 #include "bsp/board_api.h"
 #include "tusb.h"
 #include "usb_descriptors.h"
+#include "hid_reports.h"
 
 /* A combination of interfaces must have a unique product id, since PC will save device driver after the first plug.
  * Same VID/PID with different interface e.g MSC (first), then CDC (later) will possibly cause system error on PC.
@@ -38,7 +39,7 @@
                            _PID_MAP(MIDI, 3) | _PID_MAP(VENDOR, 4) )
 
 #define USB_VID   0x046D
-#define USB_BCD   0xC077
+#define USB_BCD   0x0200
 
 //--------------------------------------------------------------------+
 // Device Descriptors
@@ -61,7 +62,7 @@ tusb_desc_device_t const desc_device =
     .iProduct           = 0x02,
     .iSerialNumber      = 0x03,
 
-    .bNumConfigurations = 0x01
+    .bNumConfigurations = CONFIG_COUNT
 };
 
 // Invoked when received GET DEVICE DESCRIPTOR
@@ -75,21 +76,14 @@ uint8_t const * tud_descriptor_device_cb(void)
 // HID Report Descriptor
 //--------------------------------------------------------------------+
 
-uint8_t const desc_hid_report[] =
-{
-  //TUD_HID_REPORT_DESC_KEYBOARD( HID_REPORT_ID(REPORT_ID_KEYBOARD         )),
-  TUD_HID_REPORT_DESC_MOUSE   ( HID_REPORT_ID(REPORT_ID_MOUSE            )),
-  //TUD_HID_REPORT_DESC_CONSUMER( HID_REPORT_ID(REPORT_ID_CONSUMER_CONTROL )),
-  //TUD_HID_REPORT_DESC_GAMEPAD ( HID_REPORT_ID(REPORT_ID_GAMEPAD          ))
-};
+// desc_hid_report is generated from the typed report layouts in hid_reports.cpp
 
 // Invoked when received GET HID REPORT DESCRIPTOR
 // Application return pointer to descriptor
 // Descriptor contents must exist long enough for transfer to complete
 uint8_t const * tud_hid_descriptor_report_cb(uint8_t instance)
 {
-  (void) instance;
-  return desc_hid_report;
+  return (instance == HID_INSTANCE_HIRES) ? desc_hid_report_hires.bytes : desc_hid_report.bytes;
 }
 
 //--------------------------------------------------------------------+
@@ -101,38 +95,79 @@ enum
   ITF_NUM_CDC0 = 0, // CDC interface 0/1
   ITF_NUM_CDC0_DATA,
   ITF_NUM_HID,
+  ITF_NUM_HID_HIRES,  // high-rate configuration only
   ITF_NUM_TOTAL
 };
 
-#define  CONFIG_TOTAL_LEN  (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_HID_DESC_LEN)
+#define  CONFIG_LOW_POWER_LEN  (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_HID_DESC_LEN)
+#define  CONFIG_HIGH_RATE_LEN  (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + 2*TUD_HID_DESC_LEN)
+
+#define EPNUM_HID         0x81
+#define EPNUM_CDC_NOTIF   0x82
+#define EPNUM_CDC_OUT     0x03
+#define EPNUM_CDC_IN      0x84
+#define EPNUM_HID_HIRES   0x85
 
-#define EPNUM_HID   0x81
+// String Descriptor Index
+enum {
+  STRID_LANGID = 0,
+  STRID_MANUFACTURER,
+  STRID_PRODUCT,
+  STRID_SERIAL,
+  STRID_CONFIG_LOW_POWER,
+  STRID_CONFIG_HIGH_RATE,
+};
+
+// Lean configuration: mouse polled every 10 ms, asks for little bus power
+uint8_t const desc_configuration_low_power[] =
+{
+  // Config number, interface count, string index, total length, attribute, power in mA
+  TUD_CONFIG_DESCRIPTOR(CONFIG_LOW_POWER + 1, ITF_NUM_HID + 1, STRID_CONFIG_LOW_POWER, CONFIG_LOW_POWER_LEN, TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 50),
+
+  // Interface number, string index, EP notification address and size, EP data address (out, in) and size
+  TUD_CDC_DESCRIPTOR(ITF_NUM_CDC0, 0, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, 64),
+
+  // Interface number, string index, protocol, report descriptor len, EP In address, size & polling interval
+  TUD_HID_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_MOUSE, sizeof(desc_hid_report), EPNUM_HID, CFG_TUD_HID_EP_BUFSIZE, 10)
+};
 
-uint8_t const desc_configuration[] =
+// High-rate configuration: both HID interfaces polled every frame, motion goes out
+// with 16 bit resolution on the second one
+uint8_t const desc_configuration_high_rate[] =
 {
   // Config number, interface count, string index, total length, attribute, power in mA
-  //TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
+  TUD_CONFIG_DESCRIPTOR(CONFIG_HIGH_RATE + 1, ITF_NUM_TOTAL, STRID_CONFIG_HIGH_RATE, CONFIG_HIGH_RATE_LEN, TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
+
+  // Interface number, string index, EP notification address and size, EP data address (out, in) and size
+  TUD_CDC_DESCRIPTOR(ITF_NUM_CDC0, 0, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, 64),
 
   // Interface number, string index, protocol, report descriptor len, EP In address, size & polling interval
-  //TUD_HID_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_NONE, sizeof(desc_hid_report), EPNUM_HID, CFG_TUD_HID_EP_BUFSIZE, 5)
-<<<<<<< HEAD
-  TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
-  
-  TUD_CDC_DESCRIPTOR(ITF_NUM_CDC0, 0, 0x82, 8, 0x83, 0x84, 64),
-  
-=======
-  TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0, 100),
->>>>>>> parent of 5ffff53 (1.将pid和vid改为普通鼠标)
-  TUD_HID_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_MOUSE, sizeof(desc_hid_report), 0x81, 16, 10)
+  TUD_HID_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_MOUSE, sizeof(desc_hid_report), EPNUM_HID, CFG_TUD_HID_EP_BUFSIZE, 1),
+  TUD_HID_DESCRIPTOR(ITF_NUM_HID_HIRES, 0, HID_ITF_PROTOCOL_NONE, sizeof(desc_hid_report_hires), EPNUM_HID_HIRES, CFG_TUD_HID_EP_BUFSIZE, 1)
+};
 
+TU_VERIFY_STATIC(sizeof(desc_configuration_low_power) == CONFIG_LOW_POWER_LEN, "CONFIG_LOW_POWER_LEN does not match");
+TU_VERIFY_STATIC(sizeof(desc_configuration_high_rate) == CONFIG_HIGH_RATE_LEN, "CONFIG_HIGH_RATE_LEN does not match");
 
+// indexed by configuration index
+static uint8_t const* const desc_configurations[CONFIG_COUNT] =
+{
+  [CONFIG_LOW_POWER] = desc_configuration_low_power,
+  [CONFIG_HIGH_RATE] = desc_configuration_high_rate,
 };
 
+static uint8_t last_config_index = CONFIG_LOW_POWER;
+
+uint8_t usb_descriptors_last_config(void)
+{
+  return last_config_index;
+}
+
 #if TUD_OPT_HIGH_SPEED
 // Per USB specs: high speed capable device must report device_qualifier and other_speed_configuration
 
 // other speed configuration
-uint8_t desc_other_speed_config[CONFIG_TOTAL_LEN];
+uint8_t desc_other_speed_config[CONFIG_HIGH_RATE_LEN];
 
 // device qualifier is mostly similar to device descriptor since we don't change configuration based on speed
 tusb_desc_device_qualifier_t const desc_device_qualifier =
@@ -146,7 +181,7 @@ tusb_desc_device_qualifier_t const desc_device_qualifier =
   .bDeviceProtocol    = 0x00,
 
   .bMaxPacketSize0    = CFG_TUD_ENDPOINT0_SIZE,
-  .bNumConfigurations = 0x01,
+  .bNumConfigurations = CONFIG_COUNT,
   .bReserved          = 0x00
 };
 
@@ -164,10 +199,12 @@ uint8_t const* tud_descriptor_device_qualifier_cb(void)
 // Configuration descriptor in the other speed e.g if high speed then this is for full speed and vice versa
 uint8_t const* tud_descriptor_other_speed_configuration_cb(uint8_t index)
 {
-  (void) index; // for multiple configurations
+  if ( index >= CONFIG_COUNT ) return NULL;
+
+  uint8_t const* desc = desc_configurations[index];
 
   // other speed config is basically configuration with type = OHER_SPEED_CONFIG
-  memcpy(desc_other_speed_config, desc_configuration, CONFIG_TOTAL_LEN);
+  memcpy(desc_other_speed_config, desc, tu_le16toh(tu_unaligned_read16(desc + 2)));
   desc_other_speed_config[1] = TUSB_DESC_OTHER_SPEED_CONFIG;
 
   // this example use the same configuration for both high and full speed mode
@@ -179,26 +216,22 @@ uint8_t const* tud_descriptor_other_speed_configuration_cb(uint8_t index)
 // Invoked when received GET CONFIGURATION DESCRIPTOR
 // Application return pointer to descriptor
 // Descriptor contents must exist long enough for transfer to complete
+// Note: SET_CONFIGURATION also goes through here (with bConfigurationValue - 1) right
+// before tud_mount_cb(), which is how the application learns the selected configuration
 uint8_t const * tud_descriptor_configuration_cb(uint8_t index)
 {
-  (void) index; // for multiple configurations
+  if ( index >= CONFIG_COUNT ) return NULL;
+
+  last_config_index = index;
 
   // This example use the same configuration for both high and full speed mode
-  return desc_configuration;
+  return desc_configurations[index];
 }
 
 //--------------------------------------------------------------------+
 // String Descriptors
 //--------------------------------------------------------------------+
 
-// String Descriptor Index
-enum {
-  STRID_LANGID = 0,
-  STRID_MANUFACTURER,
-  STRID_PRODUCT,
-  STRID_SERIAL,
-};
-
 // array of pointer to string descriptors
 char const *string_desc_arr[] =
 {
@@ -206,6 +239,8 @@ char const *string_desc_arr[] =
   "TinyUSB",                     // 1: Manufacturer
   "TinyUSB Device",              // 2: Product
   NULL,                          // 3: Serials will use unique ID if possible
+  "Low power",                   // 4: CONFIG_LOW_POWER
+  "High rate",                   // 5: CONFIG_HIGH_RATE
 };
 
 static uint16_t _desc_str[32 + 1];
@@ -34,4 +34,29 @@ enum
   REPORT_ID_COUNT
 };
 
+// Report IDs of the high-rate HID interface
+enum
+{
+  REPORT_ID_HIRES_MOUSE = 1,
+};
+
+// Configuration index, i.e bConfigurationValue - 1
+enum
+{
+  CONFIG_LOW_POWER = 0, // CDC + mouse polled every 10 ms
+  CONFIG_HIGH_RATE,     // CDC + mouse + high resolution mouse, polled every 1 ms
+  CONFIG_COUNT
+};
+
+// HID instances, in interface order
+enum
+{
+  HID_INSTANCE_MOUSE = 0,
+  HID_INSTANCE_HIRES,   // only in CONFIG_HIGH_RATE
+};
+
+// Index of the configuration most recently handed to the stack. Read it in tud_mount_cb()
+// to learn which configuration the host selected with SET_CONFIGURATION.
+uint8_t usb_descriptors_last_config(void);
+
 #endif /* USB_DESCRIPTORS_H_ */
@@ -0,0 +1,144 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include "tusb.h"
+
+#include "hardware/address_mapped.h"
+#include "hardware/structs/usb.h"
+
+#include "app_config.h"
+#include "console.h"
+#include "usb_stats.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF PROTYPES
+//--------------------------------------------------------------------+
+
+typedef struct
+{
+  char const* name;
+  uint32_t bit;
+} sie_error_t;
+
+static sie_error_t const sie_errors[] =
+{
+  { "crc",         USB_SIE_STATUS_CRC_ERROR_BITS       },
+  { "bit-stuff",   USB_SIE_STATUS_BIT_STUFF_ERROR_BITS },
+  { "data-seq",    USB_SIE_STATUS_DATA_SEQ_ERROR_BITS  },
+  { "rx-timeout",  USB_SIE_STATUS_RX_TIMEOUT_BITS      },
+  { "rx-overflow", USB_SIE_STATUS_RX_OVERFLOW_BITS     },
+};
+
+#define SIE_ERROR_COUNT   TU_ARRAY_SIZE(sie_errors)
+#define SIE_ERROR_MASK    (USB_SIE_STATUS_CRC_ERROR_BITS | USB_SIE_STATUS_BIT_STUFF_ERROR_BITS | \
+                           USB_SIE_STATUS_DATA_SEQ_ERROR_BITS | USB_SIE_STATUS_RX_TIMEOUT_BITS | \
+                           USB_SIE_STATUS_RX_OVERFLOW_BITS)
+
+static struct
+{
+  uint32_t errors[SIE_ERROR_COUNT];
+  uint32_t naks[USB_NUM_ENDPOINTS][2];   // [endpoint][0: IN, 1: OUT]
+  uint32_t samples;                      // polls since the last reset
+} stats;
+
+//--------------------------------------------------------------------+
+// Public API
+//--------------------------------------------------------------------+
+
+void usb_stats_arm(void)
+{
+  // EP0 has no endpoint control register, its NAK reporting lives in SIE_CTRL
+  hw_set_bits(&usb_hw->sie_ctrl, USB_SIE_CTRL_EP0_INT_NAK_BITS);
+
+  // DPRAM has no atomic set alias, and TinyUSB only writes these from tud_task(), like us
+  for ( int ep = 1; ep < USB_NUM_ENDPOINTS; ep++ )
+  {
+    if ( usb_dpram->ep_ctrl[ep - 1].in & EP_CTRL_ENABLE_BITS ) usb_dpram->ep_ctrl[ep - 1].in |= EP_CTRL_INTERRUPT_ON_NAK;
+    if ( usb_dpram->ep_ctrl[ep - 1].out & EP_CTRL_ENABLE_BITS ) usb_dpram->ep_ctrl[ep - 1].out |= EP_CTRL_INTERRUPT_ON_NAK;
+  }
+}
+
+void __hot_path_func(usb_stats_task)(void)
+{
+  stats.samples++;
+
+  uint32_t const status = usb_hw->sie_status & SIE_ERROR_MASK;
+  if ( status )
+  {
+    usb_hw->sie_status = status; // write 1 to clear
+    for ( size_t i = 0; i < SIE_ERROR_COUNT; i++ )
+    {
+      if ( status & sie_errors[i].bit ) stats.errors[i]++;
+    }
+  }
+
+  // bit 2n: endpoint n IN, bit 2n+1: endpoint n OUT
+  uint32_t const naks = usb_hw->ep_nak_stall_status;
+  if ( naks )
+  {
+    usb_hw->ep_nak_stall_status = naks; // write 1 to clear
+    for ( uint32_t bits = naks; bits; bits &= bits - 1 )
+    {
+      uint32_t const n = (uint32_t) __builtin_ctz(bits);
+      stats.naks[n / 2][n % 2]++;
+    }
+  }
+}
+
+uint32_t usb_stats_errors(void)
+{
+  uint32_t total = 0;
+  for ( size_t i = 0; i < SIE_ERROR_COUNT; i++ ) total += stats.errors[i];
+  return total;
+}
+
+//--------------------------------------------------------------------+
+// Console
+//--------------------------------------------------------------------+
+
+void usb_stats_cmd(int argc, char* argv[])
+{
+  if ( argc == 2 && !strcmp(argv[1], "reset") )
+  {
+    memset(&stats, 0, sizeof(stats));
+    return;
+  }
+
+  console_printf("%lu samples\r\nerrors:", (unsigned long) stats.samples);
+  for ( size_t i = 0; i < SIE_ERROR_COUNT; i++ )
+  {
+    console_printf(" %s %lu", sie_errors[i].name, (unsigned long) stats.errors[i]);
+  }
+  console_printf("\r\nNAKs:");
+
+  for ( int ep = 0; ep < USB_NUM_ENDPOINTS; ep++ )
+  {
+    if ( stats.naks[ep][0] ) console_printf(" ep%d-in %lu", ep, (unsigned long) stats.naks[ep][0]);
+    if ( stats.naks[ep][1] ) console_printf(" ep%d-out %lu", ep, (unsigned long) stats.naks[ep][1]);
+  }
+  console_printf("\r\n");
+}
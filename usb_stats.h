@@ -0,0 +1,64 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 pico-mouse contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef USB_STATS_H_
+#define USB_STATS_H_
+
+#include <stdint.h>
+
+/* USB controller error and NAK counters, read from the RP2040 SIE registers.
+ *
+ * The error bits of SIE_STATUS (CRC, bit stuffing, data sequence, receive
+ * timeout and overflow) are sticky. They are polled once per main loop
+ * iteration and cleared (write 1 to clear). Enabling their interrupts is not
+ * an option: the TinyUSB driver owns the USB IRQ and treats unknown sources as
+ * fatal.
+ *
+ * Per-endpoint NAKs use the interrupt-on-NAK bit of each endpoint control
+ * register and SIE_CTRL.EP0_INT_NAK. These latch a bit per endpoint and
+ * direction in EP_STATUS_STALL_NAK without raising an interrupt. TinyUSB
+ * rewrites the endpoint control registers when it opens endpoints, so
+ * usb_stats_arm() sets the bits again after every mount.
+ *
+ * All counters count polls that found the bit set. Several events between two
+ * polls count once, so the numbers are lower bounds. With the main loop running
+ * well under the 1 ms frame time they are close to exact for NAKs.
+ * A climbing CRC or bit stuffing count points at cabling or a hub. NAKs on an
+ * interrupt IN endpoint are host polls the firmware had no report ready for.
+ */
+
+// Enable NAK reporting on the open endpoints, call from tud_mount_cb()
+void usb_stats_arm(void);
+
+// Sample and clear the status bits, call once per main loop iteration
+void usb_stats_task(void);
+
+// Sum of all error counters, for the event log
+uint32_t usb_stats_errors(void);
+
+// Console: usb [reset]
+void usb_stats_cmd(int argc, char* argv[]);
+
+#endif /* USB_STATS_H_ */